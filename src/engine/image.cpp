@@ -21,10 +21,22 @@
 #include "image.h"
 #include "image_palette.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
 
+// SSE2 is a part of every x86-64 CPU and NEON of every AArch64 CPU so no runtime detection is needed
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define FHEROES2_IMAGE_SSE2
+#define FHEROES2_IMAGE_SIMD
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#include <arm_neon.h>
+#define FHEROES2_IMAGE_NEON
+#define FHEROES2_IMAGE_SIMD
+#endif
+
 namespace
 {
     // 0 in shadow part means no shadow, 1 means skip any drawings so to don't waste extra CPU cycles for ( tableId - 2 ) command we just add extra fake tables
@@ -365,6 +377,311 @@ namespace
         return rgbToId[red + green * 64 + blue * 64 * 64];
     }
 
+#if defined( FHEROES2_IMAGE_SSE2 )
+    typedef __m128i PixelBlock;
+
+    PixelBlock loadBlock( const uint8_t * data )
+    {
+        return _mm_loadu_si128( reinterpret_cast<const __m128i *>( data ) );
+    }
+
+    // Loads the given pixel and 15 pixels before it in reverse order.
+    PixelBlock loadBlockReversed( const uint8_t * data )
+    {
+        PixelBlock block = _mm_shuffle_epi32( loadBlock( data - 15 ), _MM_SHUFFLE( 0, 1, 2, 3 ) );
+        block = _mm_shufflehi_epi16( _mm_shufflelo_epi16( block, _MM_SHUFFLE( 2, 3, 0, 1 ) ), _MM_SHUFFLE( 2, 3, 0, 1 ) );
+        return _mm_or_si128( _mm_slli_epi16( block, 8 ), _mm_srli_epi16( block, 8 ) );
+    }
+
+    void storeBlock( uint8_t * data, const PixelBlock block )
+    {
+        _mm_storeu_si128( reinterpret_cast<__m128i *>( data ), block );
+    }
+
+    PixelBlock getEqualMask( const PixelBlock block, const uint8_t value )
+    {
+        return _mm_cmpeq_epi8( block, _mm_set1_epi8( static_cast<char>( value ) ) );
+    }
+
+    PixelBlock getAboveMask( const PixelBlock block, const uint8_t value )
+    {
+        const PixelBlock limit = _mm_set1_epi8( static_cast<char>( value ) );
+        return _mm_andnot_si128( _mm_cmpeq_epi8( _mm_max_epu8( block, limit ), limit ), _mm_set1_epi8( -1 ) );
+    }
+
+    bool isAllSet( const PixelBlock mask )
+    {
+        return _mm_movemask_epi8( mask ) == 0xFFFF;
+    }
+
+    bool isNoneSet( const PixelBlock mask )
+    {
+        return _mm_movemask_epi8( mask ) == 0;
+    }
+
+    // Takes values from the first block where the mask is set and from the second block elsewhere.
+    PixelBlock selectBlock( const PixelBlock mask, const PixelBlock first, const PixelBlock second )
+    {
+        return _mm_or_si128( _mm_and_si128( mask, first ), _mm_andnot_si128( mask, second ) );
+    }
+
+    PixelBlock clearBlock( const PixelBlock mask, const PixelBlock block )
+    {
+        return _mm_andnot_si128( mask, block );
+    }
+#elif defined( FHEROES2_IMAGE_NEON )
+    typedef uint8x16_t PixelBlock;
+
+    PixelBlock loadBlock( const uint8_t * data )
+    {
+        return vld1q_u8( data );
+    }
+
+    // Loads the given pixel and 15 pixels before it in reverse order.
+    PixelBlock loadBlockReversed( const uint8_t * data )
+    {
+        const PixelBlock block = vrev64q_u8( vld1q_u8( data - 15 ) );
+        return vcombine_u8( vget_high_u8( block ), vget_low_u8( block ) );
+    }
+
+    void storeBlock( uint8_t * data, const PixelBlock block )
+    {
+        vst1q_u8( data, block );
+    }
+
+    PixelBlock getEqualMask( const PixelBlock block, const uint8_t value )
+    {
+        return vceqq_u8( block, vdupq_n_u8( value ) );
+    }
+
+    PixelBlock getAboveMask( const PixelBlock block, const uint8_t value )
+    {
+        return vcgtq_u8( block, vdupq_n_u8( value ) );
+    }
+
+    bool isNoneSet( const PixelBlock mask )
+    {
+        const uint64x2_t halves = vreinterpretq_u64_u8( mask );
+        return ( vgetq_lane_u64( halves, 0 ) | vgetq_lane_u64( halves, 1 ) ) == 0;
+    }
+
+    bool isAllSet( const PixelBlock mask )
+    {
+        return isNoneSet( vmvnq_u8( mask ) );
+    }
+
+    // Takes values from the first block where the mask is set and from the second block elsewhere.
+    PixelBlock selectBlock( const PixelBlock mask, const PixelBlock first, const PixelBlock second )
+    {
+        return vbslq_u8( mask, first, second );
+    }
+
+    PixelBlock clearBlock( const PixelBlock mask, const PixelBlock block )
+    {
+        return vbicq_u8( block, mask );
+    }
+#endif
+
+#if defined( FHEROES2_IMAGE_SIMD )
+    const int32_t pixelBlockSize = 16;
+
+    // Blits a block of 16 pixels if every pixel is either copied or skipped, which is true for the most of sprites. Returns false without any changes
+    // if some pixels need a transform table lookup. The output transform layer is nullptr for single-layer images.
+    bool blitBlock( const PixelBlock imageIn, const PixelBlock transformIn, uint8_t * imageOut, uint8_t * transformOut )
+    {
+        if ( !isNoneSet( getAboveMask( transformIn, 1 ) ) ) {
+            return false;
+        }
+
+        const PixelBlock copyMask = getEqualMask( transformIn, 0 );
+        if ( isNoneSet( copyMask ) ) {
+            return true;
+        }
+
+        if ( isAllSet( copyMask ) ) {
+            storeBlock( imageOut, imageIn );
+            if ( transformOut != nullptr ) {
+                std::fill( transformOut, transformOut + pixelBlockSize, static_cast<uint8_t>( 0 ) );
+            }
+            return true;
+        }
+
+        storeBlock( imageOut, selectBlock( copyMask, imageIn, loadBlock( imageOut ) ) );
+        if ( transformOut != nullptr ) {
+            storeBlock( transformOut, clearBlock( copyMask, loadBlock( transformOut ) ) );
+        }
+        return true;
+    }
+#endif
+
+    void blitPixel( const uint8_t imageIn, const uint8_t transformIn, uint8_t & imageOut )
+    {
+        if ( transformIn > 0 ) { // apply a transformation
+            if ( transformIn != 1 ) { // skip pixel
+                imageOut = *( transformTable + transformIn * 256 + imageOut );
+            }
+        }
+        else { // copy a pixel
+            imageOut = imageIn;
+        }
+    }
+
+    void blitPixel( const uint8_t imageIn, const uint8_t transformIn, uint8_t & imageOut, uint8_t & transformOut )
+    {
+        if ( transformIn == 1 ) { // skip pixel
+            return;
+        }
+
+        if ( transformIn > 0 && transformOut == 0 ) { // apply a transformation
+            imageOut = *( transformTable + transformIn * 256 + imageOut );
+        }
+        else { // copy a pixel
+            transformOut = transformIn;
+            imageOut = imageIn;
+        }
+    }
+
+    void blitRow( const uint8_t * imageIn, const uint8_t * transformIn, uint8_t * imageOut, const int32_t width )
+    {
+        int32_t x = 0;
+
+#if defined( FHEROES2_IMAGE_SIMD )
+        for ( ; x + pixelBlockSize <= width; x += pixelBlockSize ) {
+            if ( !blitBlock( loadBlock( imageIn + x ), loadBlock( transformIn + x ), imageOut + x, nullptr ) ) {
+                for ( int32_t i = x; i < x + pixelBlockSize; ++i ) {
+                    blitPixel( imageIn[i], transformIn[i], imageOut[i] );
+                }
+            }
+        }
+#endif
+
+        for ( ; x < width; ++x ) {
+            blitPixel( imageIn[x], transformIn[x], imageOut[x] );
+        }
+    }
+
+    void blitRow( const uint8_t * imageIn, const uint8_t * transformIn, uint8_t * imageOut, uint8_t * transformOut, const int32_t width )
+    {
+        int32_t x = 0;
+
+#if defined( FHEROES2_IMAGE_SIMD )
+        for ( ; x + pixelBlockSize <= width; x += pixelBlockSize ) {
+            if ( !blitBlock( loadBlock( imageIn + x ), loadBlock( transformIn + x ), imageOut + x, transformOut + x ) ) {
+                for ( int32_t i = x; i < x + pixelBlockSize; ++i ) {
+                    blitPixel( imageIn[i], transformIn[i], imageOut[i], transformOut[i] );
+                }
+            }
+        }
+#endif
+
+        for ( ; x < width; ++x ) {
+            blitPixel( imageIn[x], transformIn[x], imageOut[x], transformOut[x] );
+        }
+    }
+
+    // The input pointers point to the rightmost pixel of the row which is read from right to left.
+    void blitFlippedRow( const uint8_t * imageIn, const uint8_t * transformIn, uint8_t * imageOut, const int32_t width )
+    {
+        int32_t x = 0;
+
+#if defined( FHEROES2_IMAGE_SIMD )
+        for ( ; x + pixelBlockSize <= width; x += pixelBlockSize ) {
+            if ( !blitBlock( loadBlockReversed( imageIn - x ), loadBlockReversed( transformIn - x ), imageOut + x, nullptr ) ) {
+                for ( int32_t i = x; i < x + pixelBlockSize; ++i ) {
+                    blitPixel( *( imageIn - i ), *( transformIn - i ), imageOut[i] );
+                }
+            }
+        }
+#endif
+
+        for ( ; x < width; ++x ) {
+            blitPixel( *( imageIn - x ), *( transformIn - x ), imageOut[x] );
+        }
+    }
+
+    // The input pointers point to the rightmost pixel of the row which is read from right to left.
+    void blitFlippedRow( const uint8_t * imageIn, const uint8_t * transformIn, uint8_t * imageOut, uint8_t * transformOut, const int32_t width )
+    {
+        int32_t x = 0;
+
+#if defined( FHEROES2_IMAGE_SIMD )
+        for ( ; x + pixelBlockSize <= width; x += pixelBlockSize ) {
+            if ( !blitBlock( loadBlockReversed( imageIn - x ), loadBlockReversed( transformIn - x ), imageOut + x, transformOut + x ) ) {
+                for ( int32_t i = x; i < x + pixelBlockSize; ++i ) {
+                    blitPixel( *( imageIn - i ), *( transformIn - i ), imageOut[i], transformOut[i] );
+                }
+            }
+        }
+#endif
+
+        for ( ; x < width; ++x ) {
+            blitPixel( *( imageIn - x ), *( transformIn - x ), imageOut[x], transformOut[x] );
+        }
+    }
+
+    // Blits pixels of a packed sprite span. The output transform layer is nullptr for single-layer images.
+    void blitSpan( const uint8_t * pixels, const uint8_t transform, uint8_t * imageOut, uint8_t * transformOut, const int32_t length )
+    {
+        if ( transform == 0 ) {
+            memcpy( imageOut, pixels, static_cast<size_t>( length ) );
+            if ( transformOut != nullptr ) {
+                memset( transformOut, 0, static_cast<size_t>( length ) );
+            }
+            return;
+        }
+
+        for ( int32_t i = 0; i < length; ++i ) {
+            if ( transformOut == nullptr ) {
+                blitPixel( pixels[i], transform, imageOut[i] );
+            }
+            else {
+                blitPixel( pixels[i], transform, imageOut[i], transformOut[i] );
+            }
+        }
+    }
+
+    // The same as blitSpan() but the pixels are written in reverse order.
+    void blitFlippedSpan( const uint8_t * pixels, const uint8_t transform, uint8_t * imageOut, uint8_t * transformOut, const int32_t length )
+    {
+        if ( transform == 0 ) {
+            std::reverse_copy( pixels, pixels + length, imageOut );
+            if ( transformOut != nullptr ) {
+                memset( transformOut, 0, static_cast<size_t>( length ) );
+            }
+            return;
+        }
+
+        for ( int32_t i = 0; i < length; ++i ) {
+            if ( transformOut == nullptr ) {
+                blitPixel( pixels[length - 1 - i], transform, imageOut[i] );
+            }
+            else {
+                blitPixel( pixels[length - 1 - i], transform, imageOut[i], transformOut[i] );
+            }
+        }
+    }
+
+    void alphaBlitPixel( const uint8_t * gamePalette, const uint8_t imageIn, const uint8_t transformIn, uint8_t & imageOut, const uint8_t alphaValue,
+                         const uint8_t behindValue )
+    {
+        if ( transformIn == 1 ) { // skip pixel
+            return;
+        }
+
+        uint8_t inValue = imageIn;
+        if ( transformIn > 1 ) {
+            inValue = *( transformTable + transformIn * 256 + imageOut );
+        }
+
+        const uint8_t * inPAL = gamePalette + inValue * 3;
+        const uint8_t * outPAL = gamePalette + imageOut * 3;
+
+        const uint32_t red = static_cast<uint32_t>( *inPAL ) * alphaValue + static_cast<uint32_t>( *outPAL ) * behindValue;
+        const uint32_t green = static_cast<uint32_t>( *( inPAL + 1 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 1 ) ) * behindValue;
+        const uint32_t blue = static_cast<uint32_t>( *( inPAL + 2 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 2 ) ) * behindValue;
+        imageOut = GetPALColorId( static_cast<uint8_t>( red / 255 ), static_cast<uint8_t>( green / 255 ), static_cast<uint8_t>( blue / 255 ) );
+    }
+
     void ApplyRawPalette( const fheroes2::Image & in, int32_t inX, int32_t inY, fheroes2::Image & out, int32_t outX, int32_t outY, int32_t width, int32_t height,
                           const uint8_t * palette )
     {
@@ -386,6 +703,29 @@ namespace
             uint8_t * imageOutX = imageOutY;
             const uint8_t * imageInXEnd = imageInX + width;
 
+#if defined( FHEROES2_IMAGE_SIMD )
+            // Fully transparent blocks are skipped and fully opaque blocks are processed without branches
+            for ( ; imageInXEnd - imageInX >= pixelBlockSize; imageInX += pixelBlockSize, imageOutX += pixelBlockSize, transformInX += pixelBlockSize ) {
+                const PixelBlock dataMask = getEqualMask( loadBlock( transformInX ), 0 );
+                if ( isNoneSet( dataMask ) ) {
+                    continue;
+                }
+
+                if ( isAllSet( dataMask ) ) {
+                    for ( int32_t i = 0; i < pixelBlockSize; ++i ) {
+                        imageOutX[i] = palette[imageInX[i]];
+                    }
+                    continue;
+                }
+
+                for ( int32_t i = 0; i < pixelBlockSize; ++i ) {
+                    if ( transformInX[i] == 0 ) {
+                        imageOutX[i] = palette[imageInX[i]];
+                    }
+                }
+            }
+#endif
+
             for ( ; imageInX != imageInXEnd; ++imageInX, ++imageOutX, ++transformInX ) {
                 if ( *transformInX == 0 ) { // only modify pixels with data
                     *imageOutX = palette[*imageInX];
@@ -595,6 +935,65 @@ namespace fheroes2
         _y = y_;
     }
 
+    PackedSprite::PackedSprite()
+        : _width( 0 )
+        , _height( 0 )
+        , _x( 0 )
+        , _y( 0 )
+        , _rowSpans( 1, 0 )
+    {}
+
+    PackedSprite::PackedSprite( const Sprite & sprite )
+        : _width( sprite.width() )
+        , _height( sprite.height() )
+        , _x( sprite.x() )
+        , _y( sprite.y() )
+    {
+        _rowSpans.reserve( static_cast<size_t>( _height ) + 1 );
+        _rowSpans.push_back( 0 );
+
+        if ( sprite.empty() ) {
+            _width = 0;
+            _height = 0;
+            return;
+        }
+
+        const uint8_t * imageY = sprite.image();
+        const uint8_t * transformY = sprite.transform();
+
+        for ( int32_t y = 0; y < _height; ++y, imageY += _width, transformY += _width ) {
+            int32_t x = 0;
+
+            while ( x < _width ) {
+                // A single-layer sprite is always blitted as an opaque image
+                const uint8_t transform = sprite.singleLayer() ? 0 : transformY[x];
+                if ( transform == 1 ) {
+                    ++x;
+                    continue;
+                }
+
+                Span span;
+                span.offset = static_cast<uint16_t>( x );
+                span.transform = transform;
+                span.pixelOffset = static_cast<uint32_t>( _pixels.size() );
+
+                const int32_t spanEnd = std::min( _width, x + 0xFFFF );
+                while ( x < spanEnd && ( sprite.singleLayer() ? 0 : transformY[x] ) == transform ) {
+                    _pixels.push_back( imageY[x] );
+                    ++x;
+                }
+
+                span.length = static_cast<uint16_t>( x - span.offset );
+                _spans.push_back( span );
+            }
+
+            _rowSpans.push_back( static_cast<uint32_t>( _spans.size() ) );
+        }
+
+        _spans.shrink_to_fit();
+        _pixels.shrink_to_fit();
+    }
+
     ImageRestorer::ImageRestorer( Image & image )
         : _image( image )
         , _x( 0 )
@@ -772,28 +1171,8 @@ namespace fheroes2
             const uint8_t * imageOutYEnd = imageOutY + height * widthOut;
 
             for ( ; imageOutY != imageOutYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut ) {
-                const uint8_t * imageInX = imageInY;
-                const uint8_t * transformInX = transformInY;
-                uint8_t * imageOutX = imageOutY;
-                const uint8_t * imageOutXEnd = imageOutX + width;
-
-                for ( ; imageOutX != imageOutXEnd; --imageInX, --transformInX, ++imageOutX ) {
-                    if ( *transformInX == 1 ) { // skip pixel
-                        continue;
-                    }
-
-                    uint8_t inValue = *imageInX;
-                    if ( *transformInX > 1 ) {
-                        inValue = *( transformTable + ( *transformInX ) * 256 + *imageOutX );
-                    }
-
-                    const uint8_t * inPAL = gamePalette + inValue * 3;
-                    const uint8_t * outPAL = gamePalette + ( *imageOutX ) * 3;
-
-                    const uint32_t red = static_cast<uint32_t>( *inPAL ) * alphaValue + static_cast<uint32_t>( *outPAL ) * behindValue;
-                    const uint32_t green = static_cast<uint32_t>( *( inPAL + 1 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 1 ) ) * behindValue;
-                    const uint32_t blue = static_cast<uint32_t>( *( inPAL + 2 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 2 ) ) * behindValue;
-                    *imageOutX = GetPALColorId( static_cast<uint8_t>( red / 255 ), static_cast<uint8_t>( green / 255 ), static_cast<uint8_t>( blue / 255 ) );
+                for ( int32_t x = 0; x < width; ++x ) {
+                    alphaBlitPixel( gamePalette, *( imageInY - x ), *( transformInY - x ), imageOutY[x], alphaValue, behindValue );
                 }
             }
         }
@@ -806,28 +1185,23 @@ namespace fheroes2
             const uint8_t * imageInYEnd = imageInY + height * widthIn;
 
             for ( ; imageInY != imageInYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut ) {
-                const uint8_t * imageInX = imageInY;
-                const uint8_t * transformInX = transformInY;
-                uint8_t * imageOutX = imageOutY;
-                const uint8_t * imageInXEnd = imageInX + width;
+                int32_t x = 0;
 
-                for ( ; imageInX != imageInXEnd; ++imageInX, ++transformInX, ++imageOutX ) {
-                    if ( *transformInX == 1 ) { // skip pixel
+#if defined( FHEROES2_IMAGE_SIMD )
+                for ( ; x + pixelBlockSize <= width; x += pixelBlockSize ) {
+                    // Fully transparent blocks are common around sprites
+                    if ( isAllSet( getEqualMask( loadBlock( transformInY + x ), 1 ) ) ) {
                         continue;
                     }
 
-                    uint8_t inValue = *imageInX;
-                    if ( *transformInX > 1 ) {
-                        inValue = *( transformTable + ( *transformInX ) * 256 + *imageOutX );
+                    for ( int32_t i = x; i < x + pixelBlockSize; ++i ) {
+                        alphaBlitPixel( gamePalette, imageInY[i], transformInY[i], imageOutY[i], alphaValue, behindValue );
                     }
+                }
+#endif
 
-                    const uint8_t * inPAL = gamePalette + inValue * 3;
-                    const uint8_t * outPAL = gamePalette + ( *imageOutX ) * 3;
-
-                    const uint32_t red = static_cast<uint32_t>( *inPAL ) * alphaValue + static_cast<uint32_t>( *outPAL ) * behindValue;
-                    const uint32_t green = static_cast<uint32_t>( *( inPAL + 1 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 1 ) ) * behindValue;
-                    const uint32_t blue = static_cast<uint32_t>( *( inPAL + 2 ) ) * alphaValue + static_cast<uint32_t>( *( outPAL + 2 ) ) * behindValue;
-                    *imageOutX = GetPALColorId( static_cast<uint8_t>( red / 255 ), static_cast<uint8_t>( green / 255 ), static_cast<uint8_t>( blue / 255 ) );
+                for ( ; x < width; ++x ) {
+                    alphaBlitPixel( gamePalette, imageInY[x], transformInY[x], imageOutY[x], alphaValue, behindValue );
                 }
             }
         }
@@ -977,46 +1351,14 @@ namespace fheroes2
             if ( out.singleLayer() ) {
                 assert( !in.singleLayer() );
                 for ( ; imageOutY != imageOutYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut ) {
-                    const uint8_t * imageInX = imageInY;
-                    const uint8_t * transformInX = transformInY;
-                    uint8_t * imageOutX = imageOutY;
-                    const uint8_t * imageOutXEnd = imageOutX + width;
-
-                    for ( ; imageOutX != imageOutXEnd; --imageInX, --transformInX, ++imageOutX ) {
-                        if ( *transformInX > 0 ) { // apply a transformation
-                            if ( *transformInX != 1 ) { // skip pixel
-                                *imageOutX = *( transformTable + ( *transformInX ) * 256 + *imageOutX );
-                            }
-                        }
-                        else { // copy a pixel
-                            *imageOutX = *imageInX;
-                        }
-                    }
+                    blitFlippedRow( imageInY, transformInY, imageOutY, width );
                 }
             }
             else {
                 uint8_t * transformOutY = out.transform() + offsetOutY;
 
                 for ( ; imageOutY != imageOutYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut, transformOutY += widthOut ) {
-                    const uint8_t * imageInX = imageInY;
-                    const uint8_t * transformInX = transformInY;
-                    uint8_t * imageOutX = imageOutY;
-                    uint8_t * transformOutX = transformOutY;
-                    const uint8_t * imageOutXEnd = imageOutX + width;
-
-                    for ( ; imageOutX != imageOutXEnd; --imageInX, --transformInX, ++imageOutX, ++transformOutX ) {
-                        if ( *transformInX == 1 ) { // skip pixel
-                            continue;
-                        }
-
-                        if ( *transformInX > 0 && *transformOutX == 0 ) { // apply a transformation
-                            *imageOutX = *( transformTable + ( *transformInX ) * 256 + *imageOutX );
-                        }
-                        else { // copy a pixel
-                            *transformOutX = *transformInX;
-                            *imageOutX = *imageInX;
-                        }
-                    }
+                    blitFlippedRow( imageInY, transformInY, imageOutY, transformOutY, width );
                 }
             }
         }
@@ -1032,46 +1374,14 @@ namespace fheroes2
             if ( out.singleLayer() ) {
                 assert( !in.singleLayer() );
                 for ( ; imageInY != imageInYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut ) {
-                    const uint8_t * imageInX = imageInY;
-                    const uint8_t * transformInX = transformInY;
-                    uint8_t * imageOutX = imageOutY;
-                    const uint8_t * imageInXEnd = imageInX + width;
-
-                    for ( ; imageInX != imageInXEnd; ++imageInX, ++transformInX, ++imageOutX ) {
-                        if ( *transformInX > 0 ) { // apply a transformation
-                            if ( *transformInX != 1 ) { // skip pixel
-                                *imageOutX = *( transformTable + ( *transformInX ) * 256 + *imageOutX );
-                            }
-                        }
-                        else { // copy a pixel
-                            *imageOutX = *imageInX;
-                        }
-                    }
+                    blitRow( imageInY, transformInY, imageOutY, width );
                 }
             }
             else {
                 uint8_t * transformOutY = out.transform() + offsetOutY;
 
                 for ( ; imageInY != imageInYEnd; imageInY += widthIn, transformInY += widthIn, imageOutY += widthOut, transformOutY += widthOut ) {
-                    const uint8_t * imageInX = imageInY;
-                    const uint8_t * transformInX = transformInY;
-                    uint8_t * imageOutX = imageOutY;
-                    uint8_t * transformOutX = transformOutY;
-                    const uint8_t * imageInXEnd = imageInX + width;
-
-                    for ( ; imageInX != imageInXEnd; ++imageInX, ++transformInX, ++imageOutX, ++transformOutX ) {
-                        if ( *transformInX == 1 ) { // skip pixel
-                            continue;
-                        }
-
-                        if ( *transformInX > 0 && *transformOutX == 0 ) { // apply a transformation
-                            *imageOutX = *( transformTable + ( *transformInX ) * 256 + *imageOutX );
-                        }
-                        else { // copy a pixel
-                            *transformOutX = *transformInX;
-                            *imageOutX = *imageInX;
-                        }
-                    }
+                    blitRow( imageInY, transformInY, imageOutY, transformOutY, width );
                 }
             }
         }
@@ -1085,6 +1395,57 @@ namespace fheroes2
         Blit( in, inPos.x, inPos.y, out, outPos.x, outPos.y, size.width, size.height, flip );
     }
 
+    void Blit( const PackedSprite & in, Image & out, int32_t outX, int32_t outY, bool flip )
+    {
+        Blit( in, 0, 0, out, outX, outY, in.width(), in.height(), flip );
+    }
+
+    void Blit( const PackedSprite & in, int32_t inX, int32_t inY, Image & out, int32_t outX, int32_t outY, int32_t width, int32_t height, bool flip )
+    {
+        if ( !Verify( inX, inY, outX, outY, width, height, in.width(), in.height(), out.width(), out.height() ) ) {
+            return;
+        }
+
+        const int32_t widthOut = out.width();
+        const int32_t offsetOutY = outY * widthOut + outX;
+        uint8_t * imageOutY = out.image() + offsetOutY;
+        uint8_t * transformOutY = out.singleLayer() ? nullptr : out.transform() + offsetOutY;
+
+        // Visible columns of the input sprite, a flipped sprite is read from right to left
+        const int32_t beginX = flip ? in.width() - inX - width : inX;
+        const int32_t endX = beginX + width;
+
+        for ( int32_t y = inY; y < inY + height; ++y ) {
+            const PackedSprite::Span * span = in._spans.data() + in._rowSpans[y];
+            const PackedSprite::Span * spanEnd = in._spans.data() + in._rowSpans[y + 1];
+
+            for ( ; span != spanEnd && span->offset < endX; ++span ) {
+                const int32_t spanBegin = std::max( static_cast<int32_t>( span->offset ), beginX );
+                const int32_t spanEndX = std::min( static_cast<int32_t>( span->offset ) + span->length, endX );
+                if ( spanBegin >= spanEndX ) {
+                    continue;
+                }
+
+                const uint8_t * pixels = in._pixels.data() + span->pixelOffset + ( spanBegin - span->offset );
+                const int32_t length = spanEndX - spanBegin;
+
+                if ( flip ) {
+                    const int32_t offsetX = endX - spanEndX;
+                    blitFlippedSpan( pixels, span->transform, imageOutY + offsetX, transformOutY == nullptr ? nullptr : transformOutY + offsetX, length );
+                }
+                else {
+                    const int32_t offsetX = spanBegin - beginX;
+                    blitSpan( pixels, span->transform, imageOutY + offsetX, transformOutY == nullptr ? nullptr : transformOutY + offsetX, length );
+                }
+            }
+
+            imageOutY += widthOut;
+            if ( transformOutY != nullptr ) {
+                transformOutY += widthOut;
+            }
+        }
+    }
+
     void Copy( const Image & in, Image & out )
     {
         out.resize( in.width(), in.height() );
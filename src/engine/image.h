@@ -134,6 +134,56 @@ namespace fheroes2
         int32_t _y;
     };
 
+    // Sprite which keeps only visible pixels as runs (spans) within every row. Transparent pixels take no memory and no time to blit
+    // which makes it suitable for map objects and other sprites with a lot of empty space. It can't be modified after creation.
+    class PackedSprite
+    {
+    public:
+        PackedSprite();
+        explicit PackedSprite( const Sprite & sprite );
+
+        int32_t width() const
+        {
+            return _width;
+        }
+
+        int32_t height() const
+        {
+            return _height;
+        }
+
+        int32_t x() const
+        {
+            return _x;
+        }
+
+        int32_t y() const
+        {
+            return _y;
+        }
+
+    private:
+        friend void Blit( const PackedSprite & in, int32_t inX, int32_t inY, Image & out, int32_t outX, int32_t outY, int32_t width, int32_t height, bool flip );
+
+        struct Span
+        {
+            uint16_t offset; // position of the first pixel within the row
+            uint16_t length;
+            uint8_t transform; // 0 for opaque pixels, otherwise the transform layer value of all pixels of the span
+            uint32_t pixelOffset; // position of the first pixel in _pixels
+        };
+
+        int32_t _width;
+        int32_t _height;
+        int32_t _x;
+        int32_t _y;
+
+        // Spans of the row y are [_rowSpans[y], _rowSpans[y + 1]) in _spans
+        std::vector<uint32_t> _rowSpans;
+        std::vector<Span> _spans;
+        std::vector<uint8_t> _pixels;
+    };
+
     // This class is used in situations when we draw a window within another window
     class ImageRestorer
     {
@@ -217,6 +267,10 @@ namespace fheroes2
     // inPos must contain non-negative values
     void Blit( const Image & in, const Point & inPos, Image & out, const Point & outPos, const Size & size, bool flip = false );
 
+    // The result is identical to blitting of the original sprite
+    void Blit( const PackedSprite & in, Image & out, int32_t outX, int32_t outY, bool flip = false );
+    void Blit( const PackedSprite & in, int32_t inX, int32_t inY, Image & out, int32_t outX, int32_t outY, int32_t width, int32_t height, bool flip = false );
+
     void Copy( const Image & in, Image & out );
     void Copy( const Image & in, int32_t inX, int32_t inY, Image & out, int32_t outX, int32_t outY, int32_t width, int32_t height );
 
@@ -20,6 +20,7 @@
 
 #include "screen.h"
 #include "image_palette.h"
+#include "thread_pool.h"
 #include "tools.h"
 
 #include <SDL_version.h>
@@ -191,6 +192,46 @@ namespace
         std::vector<uint32_t> _palette32Bit;
         std::vector<SDL_Color> _palette8Bit;
 
+        // Converts the given area of the image into 32-bit pixels written row by row with the given pitch (in pixels). Large areas are converted
+        // in bands of rows on several threads.
+        void copyImageTo32Bit( const fheroes2::Image & image, const fheroes2::Rect & roi, uint32_t * out, const int32_t outPitch ) const
+        {
+            const size_t imageWidth = static_cast<size_t>( image.width() );
+            const size_t pitch = static_cast<size_t>( outPitch );
+            const size_t width = static_cast<size_t>( roi.width );
+            const uint8_t * in = image.image() + roi.x + roi.y * imageWidth;
+            const uint32_t * palette = _palette32Bit.data();
+
+            const auto convertRows = [in, out, imageWidth, pitch, width, palette]( const size_t begin, const size_t end ) {
+                for ( size_t y = begin; y < end; ++y ) {
+                    const uint8_t * inX = in + y * imageWidth;
+                    const uint8_t * inXEnd = inX + width;
+                    uint32_t * outX = out + y * pitch;
+
+                    // Independent lookups let the CPU load several palette entries at the same time
+                    for ( ; inXEnd - inX >= 4; inX += 4, outX += 4 ) {
+                        outX[0] = palette[inX[0]];
+                        outX[1] = palette[inX[1]];
+                        outX[2] = palette[inX[2]];
+                        outX[3] = palette[inX[3]];
+                    }
+
+                    for ( ; inX != inXEnd; ++inX, ++outX ) {
+                        *outX = palette[*inX];
+                    }
+                }
+            };
+
+            // Starting threads costs more than converting a small area such as a mouse cursor
+            const size_t minPixelsForThreads = 256 * 1024;
+            if ( width * static_cast<size_t>( roi.height ) < minPixelsForThreads ) {
+                convertRows( 0, static_cast<size_t>( roi.height ) );
+            }
+            else {
+                fheroes2::parallelFor( static_cast<size_t>( roi.height ), convertRows );
+            }
+        }
+
         void copyImageToSurface( const fheroes2::Image & image, SDL_Surface * surface, const fheroes2::Rect & roi )
         {
             assert( surface != nullptr && !image.empty() );
@@ -205,13 +246,7 @@ namespace
 
             if ( fullFrame ) {
                 if ( surface->format->BitsPerPixel == 32 ) {
-                    uint32_t * out = static_cast<uint32_t *>( surface->pixels );
-                    const uint32_t * outEnd = out + imageWidth * imageHeight;
-                    const uint8_t * in = image.image();
-                    const uint32_t * transform = _palette32Bit.data();
-
-                    for ( ; out != outEnd; ++out, ++in )
-                        *out = *( transform + *in );
+                    copyImageTo32Bit( image, roi, static_cast<uint32_t *>( surface->pixels ), imageWidth );
                 }
                 else if ( surface->format->BitsPerPixel == 8 ) {
                     if ( surface->pixels != image.image() ) {
@@ -230,19 +265,7 @@ namespace
             }
             else {
                 if ( surface->format->BitsPerPixel == 32 ) {
-                    uint32_t * outY = static_cast<uint32_t *>( surface->pixels );
-                    const uint32_t * outYEnd = outY + imageWidth * roi.height;
-                    const uint8_t * inY = image.image() + roi.x + roi.y * imageWidth;
-                    const uint32_t * transform = _palette32Bit.data();
-
-                    for ( ; outY != outYEnd; outY += imageWidth, inY += imageWidth ) {
-                        uint32_t * outX = outY;
-                        const uint32_t * outXEnd = outX + roi.width;
-                        const uint8_t * inX = inY;
-
-                        for ( ; outX != outXEnd; ++outX, ++inX )
-                            *outX = *( transform + *inX );
-                    }
+                    copyImageTo32Bit( image, roi, static_cast<uint32_t *>( surface->pixels ), imageWidth );
                 }
                 else if ( surface->format->BitsPerPixel == 8 ) {
                     if ( surface->pixels != image.image() ) {
@@ -820,6 +843,7 @@ namespace
             , _texture( nullptr )
             , _prevWindowPos( SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED )
             , _isVSyncEnabled( false )
+            , _isStreamingTexture( false )
         {}
 
         void clear() override
@@ -829,6 +853,8 @@ namespace
                 _texture = nullptr;
             }
 
+            _isStreamingTexture = false;
+
             if ( _renderer != nullptr ) {
                 SDL_DestroyRenderer( _renderer );
                 _renderer = nullptr;
@@ -858,7 +884,12 @@ namespace
             if ( _surface == nullptr )
                 return;
 
-            copyImageToSurface( display, _surface, roi );
+            if ( _isStreamingTexture ) {
+                copyImageToTexture( display, roi );
+            }
+            else {
+                copyImageToSurface( display, _surface, roi );
+            }
 
             if ( _texture == nullptr ) {
                 if ( _renderer != nullptr )
@@ -869,7 +900,9 @@ namespace
             else {
                 const bool fullFrame = ( roi.width == display.width() ) && ( roi.height == display.height() );
                 if ( fullFrame ) {
-                    SDL_UpdateTexture( _texture, nullptr, _surface->pixels, _surface->pitch );
+                    if ( !_isStreamingTexture ) {
+                        SDL_UpdateTexture( _texture, nullptr, _surface->pixels, _surface->pitch );
+                    }
                     if ( SDL_SetRenderTarget( _renderer, nullptr ) == 0 ) {
                         if ( SDL_RenderClear( _renderer ) == 0 && SDL_RenderCopy( _renderer, _texture, nullptr, nullptr ) == 0 ) {
                             SDL_RenderPresent( _renderer );
@@ -883,7 +916,9 @@ namespace
                     area.w = roi.width;
                     area.h = roi.height;
 
-                    SDL_UpdateTexture( _texture, &area, _surface->pixels, _surface->pitch );
+                    if ( !_isStreamingTexture ) {
+                        SDL_UpdateTexture( _texture, &area, _surface->pixels, _surface->pitch );
+                    }
                     if ( SDL_SetRenderTarget( _renderer, nullptr ) == 0 && SDL_RenderCopy( _renderer, _texture, nullptr, nullptr ) == 0 ) {
                         SDL_RenderPresent( _renderer );
                     }
@@ -958,7 +993,17 @@ namespace
                 clear();
                 return false;
             }
-            _texture = SDL_CreateTextureFromSurface( _renderer, _surface );
+            // A 32-bit frame is written straight into a streaming texture to avoid an extra copy through the surface.
+            // The surface is still used to describe the pixel format.
+            if ( _surface->format->BitsPerPixel == 32 ) {
+                _texture = SDL_CreateTexture( _renderer, _surface->format->format, SDL_TEXTUREACCESS_STREAMING, width_, height_ );
+                _isStreamingTexture = ( _texture != nullptr );
+            }
+
+            if ( _texture == nullptr ) {
+                _texture = SDL_CreateTextureFromSurface( _renderer, _surface );
+            }
+
             if ( _texture == nullptr ) {
                 clear();
                 return false;
@@ -1001,6 +1046,7 @@ namespace
         fheroes2::Size _windowedSize;
 
         bool _isVSyncEnabled;
+        bool _isStreamingTexture;
 
         int renderFlags() const
         {
@@ -1011,6 +1057,27 @@ namespace
             return SDL_RENDERER_ACCELERATED;
         }
 
+        void copyImageToTexture( const fheroes2::Display & display, const fheroes2::Rect & roi )
+        {
+            assert( _texture != nullptr && !display.empty() );
+
+            SDL_Rect area;
+            area.x = roi.x;
+            area.y = roi.y;
+            area.w = roi.width;
+            area.h = roi.height;
+
+            void * pixels = nullptr;
+            int pitch = 0;
+            if ( SDL_LockTexture( _texture, &area, &pixels, &pitch ) != 0 ) {
+                return;
+            }
+
+            copyImageTo32Bit( display, roi, static_cast<uint32_t *>( pixels ), pitch / 4 );
+
+            SDL_UnlockTexture( _texture );
+        }
+
         void _createPalette()
         {
             if ( _surface == nullptr )
@@ -0,0 +1,195 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2021                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Set for pool threads and for a caller thread while it runs a task. Nested calls are processed on the same thread.
+    thread_local bool isInsideParallelTask = false;
+
+    class ThreadPool
+    {
+    public:
+        ThreadPool()
+        {
+            const unsigned int threadCount = std::thread::hardware_concurrency();
+            for ( unsigned int i = 1; i < threadCount; ++i ) {
+                _workers.emplace_back( &ThreadPool::workerLoop, this );
+            }
+        }
+
+        ThreadPool( const ThreadPool & ) = delete;
+        ThreadPool & operator=( const ThreadPool & ) = delete;
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock( _mutex );
+                _stop = true;
+            }
+
+            _taskCondition.notify_all();
+
+            for ( std::thread & worker : _workers ) {
+                worker.join();
+            }
+        }
+
+        size_t threadCount() const
+        {
+            return _workers.size() + 1;
+        }
+
+        void run( const size_t count, const std::function<void( const size_t, const size_t )> & function )
+        {
+            if ( count == 0 ) {
+                return;
+            }
+
+            // A few chunks per thread give a better balance when chunks take different time
+            const size_t chunkCount = std::min( count, threadCount() * 4 );
+            if ( chunkCount < 2 || isInsideParallelTask ) {
+                function( 0, count );
+                return;
+            }
+
+            std::lock_guard<std::mutex> runLock( _runMutex );
+
+            isInsideParallelTask = true;
+
+            {
+                std::lock_guard<std::mutex> lock( _mutex );
+
+                _task = &function;
+                _count = count;
+                _chunkCount = chunkCount;
+                _nextChunk = 0;
+                ++_generation;
+            }
+
+            _taskCondition.notify_all();
+
+            processChunks( function, count, chunkCount );
+
+            std::unique_lock<std::mutex> lock( _mutex );
+            _doneCondition.wait( lock, [this]() { return _busyWorkers == 0; } );
+
+            // Workers which wake up too late will find no task to join
+            _task = nullptr;
+
+            isInsideParallelTask = false;
+        }
+
+    private:
+        std::vector<std::thread> _workers;
+
+        std::mutex _runMutex;
+        std::mutex _mutex;
+        std::condition_variable _taskCondition;
+        std::condition_variable _doneCondition;
+
+        const std::function<void( const size_t, const size_t )> * _task = nullptr;
+        size_t _count = 0;
+        size_t _chunkCount = 0;
+        std::atomic<size_t> _nextChunk{ 0 };
+        size_t _busyWorkers = 0;
+        uint64_t _generation = 0;
+        bool _stop = false;
+
+        void processChunks( const std::function<void( const size_t, const size_t )> & function, const size_t count, const size_t chunkCount )
+        {
+            while ( true ) {
+                const size_t chunk = _nextChunk++;
+                if ( chunk >= chunkCount ) {
+                    break;
+                }
+
+                function( count * chunk / chunkCount, count * ( chunk + 1 ) / chunkCount );
+            }
+        }
+
+        void workerLoop()
+        {
+            isInsideParallelTask = true;
+
+            uint64_t processedGeneration = 0;
+
+            std::unique_lock<std::mutex> lock( _mutex );
+
+            while ( true ) {
+                _taskCondition.wait( lock, [this, &processedGeneration]() { return _stop || _generation != processedGeneration; } );
+
+                if ( _stop ) {
+                    return;
+                }
+
+                processedGeneration = _generation;
+
+                if ( _task == nullptr ) {
+                    continue;
+                }
+
+                const std::function<void( const size_t, const size_t )> & function = *_task;
+                const size_t count = _count;
+                const size_t chunkCount = _chunkCount;
+
+                ++_busyWorkers;
+                lock.unlock();
+
+                processChunks( function, count, chunkCount );
+
+                lock.lock();
+                --_busyWorkers;
+
+                if ( _busyWorkers == 0 ) {
+                    _doneCondition.notify_all();
+                }
+            }
+        }
+    };
+
+    ThreadPool & getThreadPool()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+}
+
+namespace fheroes2
+{
+    void parallelFor( const size_t count, const std::function<void( const size_t, const size_t )> & function )
+    {
+        getThreadPool().run( count, function );
+    }
+
+    size_t getParallelThreadCount()
+    {
+        return getThreadPool().threadCount();
+    }
+}
@@ -0,0 +1,36 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2021                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace fheroes2
+{
+    // Splits the range [0, count) into chunks and processes them on a pool of persistent worker threads, the calling thread takes part
+    // in the work as well. The function is called with the [begin, end) bounds of a chunk and must be safe to run concurrently for
+    // different chunks. The call returns only when the whole range is processed. Calls from different threads are serialized, nested calls
+    // from inside the processed function run the whole range on the current thread.
+    void parallelFor( const size_t count, const std::function<void( const size_t, const size_t )> & function );
+
+    // Returns the number of threads (including the calling one) used by parallelFor().
+    size_t getParallelThreadCount();
+}
@@ -660,9 +660,12 @@ AGG::AGGInitializer::AGGInitializer()
     display.fill( 0 );
     fheroes2::Copy( image, 0, 0, display, ( display.width() - image.width() ) / 2, ( display.height() - image.height() ) / 2, image.width(), image.height() );
 
-    LocalEvent & le = LocalEvent::Get();
-    while ( le.HandleEvents() && !le.KeyPress() && !le.MouseClickLeft() ) {
-        // Do nothing.
+    // Without a display there is nobody to wait for.
+    if ( !display.empty() ) {
+        LocalEvent & le = LocalEvent::Get();
+        while ( le.HandleEvents() && !le.KeyPress() && !le.MouseClickLeft() ) {
+            // Do nothing.
+        }
     }
 
     DEBUG_LOG( DBG_ENGINE, DBG_WARN, "No data files found." );
@@ -22,6 +22,7 @@
 #include <cassert>
 #include <cstring>
 #include <map>
+#include <utility>
 #include <vector>
 
 #include "agg.h"
@@ -44,8 +45,10 @@ namespace
     const std::array<const char *, TIL::LASTTIL> tilFileName = { "UNKNOWN", "CLOF32.TIL", "GROUND32.TIL", "STON.TIL" };
 
     std::vector<std::vector<fheroes2::Sprite>> _icnVsSprite( ICN::LASTICN );
+    std::vector<std::vector<fheroes2::PackedSprite>> _icnVsPackedSprite( ICN::LASTICN );
     std::vector<std::vector<std::vector<fheroes2::Image>>> _tilVsImage( TIL::LASTTIL );
     const fheroes2::Sprite errorImage;
+    const fheroes2::PackedSprite errorPackedImage;
 
     const uint32_t headerSize = 6;
 
@@ -1454,7 +1457,9 @@ namespace fheroes2
 {
     namespace AGG
     {
-        void LoadOriginalICN( int id )
+        // Decodes an original ICN one sprite at a time: the handler gets the index, the total number of sprites and the decoded sprite
+        template <typename SpriteHandler>
+        void DecodeOriginalICN( int id, SpriteHandler handler )
         {
             const std::vector<uint8_t> & body = ::AGG::ReadChunk( ICN::GetString( id ) );
 
@@ -1470,8 +1475,6 @@ namespace fheroes2
                 return;
             }
 
-            _icnVsSprite[id].resize( count );
-
             for ( uint32_t i = 0; i < count; ++i ) {
                 imageStream.seek( headerSize + i * 13 );
 
@@ -1490,11 +1493,24 @@ namespace fheroes2
 
                 const uint8_t * data = body.data() + headerSize + header1.offsetData;
 
-                _icnVsSprite[id][i]
-                    = decodeICNSprite( data, sizeData, header1.width, header1.height, static_cast<int16_t>( header1.offsetX ), static_cast<int16_t>( header1.offsetY ) );
+                handler( i, count,
+                         decodeICNSprite( data, sizeData, header1.width, header1.height, static_cast<int16_t>( header1.offsetX ),
+                                          static_cast<int16_t>( header1.offsetY ) ) );
             }
         }
 
+        void LoadOriginalICN( int id )
+        {
+            std::vector<Sprite> & sprites = _icnVsSprite[id];
+
+            DecodeOriginalICN( id, [&sprites]( const uint32_t index, const uint32_t count, Sprite && sprite ) {
+                if ( index == 0 ) {
+                    sprites.resize( count );
+                }
+                sprites[index] = std::move( sprite );
+            } );
+        }
+
         // Helper function for LoadModifiedICN
         void CopyICNWithPalette( int icnId, int originalIcnId, const PAL::PaletteType paletteType )
         {
@@ -2795,6 +2811,42 @@ namespace fheroes2
             return _icnVsSprite[icnId][index];
         }
 
+        const PackedSprite & GetPackedICN( int icnId, uint32_t index )
+        {
+            if ( !IsValidICNId( icnId ) ) {
+                return errorPackedImage;
+            }
+
+            assert( !IsScalableICN( icnId ) );
+
+            std::vector<PackedSprite> & packedSprites = _icnVsPackedSprite[icnId];
+            if ( packedSprites.empty() ) {
+                if ( !_icnVsSprite[icnId].empty() || LoadModifiedICN( icnId ) ) {
+                    // The full sprites are already in use or have been generated so the packed ones are made from them
+                    const std::vector<Sprite> & sprites = _icnVsSprite[icnId];
+                    packedSprites.reserve( sprites.size() );
+                    for ( const Sprite & sprite : sprites ) {
+                        packedSprites.emplace_back( sprite );
+                    }
+                }
+                else {
+                    // Map objects are normally drawn only in the packed form so their full sprites are not kept
+                    DecodeOriginalICN( icnId, [&packedSprites]( const uint32_t spriteIndex, const uint32_t count, const Sprite & sprite ) {
+                        if ( spriteIndex == 0 ) {
+                            packedSprites.reserve( count );
+                        }
+                        packedSprites.emplace_back( sprite );
+                    } );
+                }
+            }
+
+            if ( index >= packedSprites.size() ) {
+                return errorPackedImage;
+            }
+
+            return packedSprites[index];
+        }
+
         uint32_t GetICNCount( int icnId )
         {
             if ( !IsValidICNId( icnId ) ) {
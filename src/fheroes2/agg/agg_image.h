@@ -25,6 +25,7 @@
 namespace fheroes2
 {
     class Image;
+    class PackedSprite;
     class Sprite;
     enum class FontSize : uint8_t;
     struct FontType;
@@ -32,9 +33,16 @@ namespace fheroes2
 
     namespace AGG
     {
+        // Images are loaded on the first request. Loading is not thread-safe: images which are going to be read from several threads
+        // at once must be requested on the main thread beforehand.
         const Sprite & GetICN( int icnId, uint32_t index );
         uint32_t GetICNCount( int icnId );
 
+        // Returns the same sprite as GetICN() in the packed form which is faster to draw. Only for ICNs which are never changed after loading
+        // (map objects, monsters and so on) and never scaled. If GetICN() has not been called for the ICN yet the packed sprites are made
+        // directly from the ICN data and the full sprites are not kept.
+        const PackedSprite & GetPackedICN( int icnId, uint32_t index );
+
         // shapeId could be 0, 1, 2 or 3 only
         const Image & GetTIL( int tilId, uint32_t index, uint32_t shapeId );
         const Sprite & GetLetter( uint32_t character, uint32_t fontType );
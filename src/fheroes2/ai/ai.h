@@ -101,6 +101,7 @@ namespace AI
 
         virtual void Reset();
         virtual void resetPathfinder() = 0;
+        virtual void updatePathfinder( const int changedTileIndex, const bool isProtectionChanged ) = 0;
 
         virtual ~Base() = default;
 
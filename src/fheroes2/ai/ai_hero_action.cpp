@@ -29,6 +29,7 @@
 #include "battle.h"
 #include "castle.h"
 #include "game.h"
+#include "game_benchmark.h"
 #include "game_delays.h"
 #include "game_interface.h"
 #include "heroes.h"
@@ -1582,6 +1583,8 @@ namespace AI
 
     void HeroesMove( Heroes & hero )
     {
+        const Game::Benchmark::PhaseTimer timer( Game::Benchmark::Phase::HERO_MOVE );
+
         const Route::Path & path = hero.GetPath();
 
         if ( path.isValid() ) {
@@ -35,6 +35,11 @@ namespace AI
         _pathfinder.reset();
     }
 
+    void Normal::updatePathfinder( const int changedTileIndex, const bool isProtectionChanged )
+    {
+        _pathfinder.invalidateTile( changedTileIndex, isProtectionChanged );
+    }
+
     void Normal::revealFog( const Maps::Tiles & tile )
     {
         _mapObjects.emplace_back( tile.GetIndex(), tile.GetObject() );
@@ -102,6 +102,10 @@ namespace AI
         double getSpellHasteRatio( const Battle::Unit & target ) const;
         uint32_t spellDurationMultiplier( const Battle::Unit & target ) const;
 
+        // Lookahead search mode: chooses the best of the given targets the current unit can attack right now by exploring a few
+        // following unit turns in a simplified battle. Returns nullptr if the search hasn't completed even the first turn in time.
+        const Battle::Unit * lookaheadAttackTarget( Battle::Arena & arena, const Battle::Unit & currentUnit, const std::vector<const Battle::Unit *> & targets ) const;
+
         // turn variables that wouldn't persist
         const HeroBase * _commander = nullptr;
         int _myColor = Color::NONE;
@@ -138,6 +142,7 @@ namespace AI
         double getObjectValue( const Heroes & hero, const int index, const double valueToIgnore, const uint32_t distanceToObject ) const;
         int getPriorityTarget( const Heroes & hero, double & maxPriority, int patrolIndex = -1, uint32_t distanceLimit = 0 );
         void resetPathfinder() override;
+        void updatePathfinder( const int changedTileIndex, const bool isProtectionChanged ) override;
 
     private:
         // following data won't be saved/serialized
@@ -145,7 +150,6 @@ namespace AI
         std::vector<IndexObject> _mapObjects;
         std::vector<RegionStats> _regions;
         AIWorldPathfinder _pathfinder;
-        BattlePlanner _battlePlanner;
 
         double getHunterObjectValue( const Heroes & hero, const int index, const double valueToIgnore, const uint32_t distanceToObject ) const;
 
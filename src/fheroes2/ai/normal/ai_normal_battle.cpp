@@ -29,11 +29,13 @@
 #include "castle.h"
 #include "difficulty.h"
 #include "game.h"
+#include "game_benchmark.h"
 #include "heroes.h"
 #include "logging.h"
 #include "settings.h"
 #include "speed.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
@@ -80,6 +82,11 @@ namespace AI
         // Shuffle to make equal quality moves a bit unpredictable
         randomGenerator.Shuffle( around );
 
+        // None of the cells around the target can be reached. The shuffle above is still performed to keep the sequence of random numbers.
+        if ( ( Board::GetAroundMask( defender ) & arena.getPassableMask() ).none() ) {
+            return bestOutcome;
+        }
+
         for ( const int cell : around ) {
             // Check if we can reach the target and pick best position to attack from
             if ( !arena.hexIsPassable( cell ) )
@@ -238,7 +245,7 @@ namespace AI
 
         if ( currentUnit.isArchers() ) {
             const Actions & archerActions = archerDecision( arena, currentUnit );
-            actions.insert( actions.end(), archerActions.begin(), archerActions.end() );
+            actions.append( archerActions );
         }
         else {
             // Melee unit decision tree (both flyers and walkers)
@@ -502,10 +509,9 @@ namespace AI
 
                 if ( currentUnit.isAbilityPresent( fheroes2::MonsterAbilityType::AREA_SHOT ) ) {
                     // TODO: update logic to handle tail case as well. Right now archers always shoot to head.
-                    const Indexes around = Board::GetAroundIndexes( enemy->GetHeadIndex() );
                     std::set<const Unit *> targetedUnits;
 
-                    for ( const int32_t cellId : around ) {
+                    for ( const int32_t cellId : Board::GetAroundIndexesView( enemy->GetHeadIndex() ) ) {
                         const Unit * monsterOnCell = Board::GetCell( cellId )->GetUnit();
                         if ( monsterOnCell != nullptr ) {
                             targetedUnits.emplace( monsterOnCell );
@@ -527,6 +533,13 @@ namespace AI
                 }
             }
 
+            if ( target.unit && enemies.size() > 1 && Settings::Get().ExtBattleAILookahead() ) {
+                const Unit * lookaheadTarget = lookaheadAttackTarget( arena, currentUnit, std::vector<const Unit *>( enemies.begin(), enemies.end() ) );
+                if ( lookaheadTarget != nullptr ) {
+                    target.unit = lookaheadTarget;
+                }
+            }
+
             if ( target.unit ) {
                 actions.emplace_back( CommandType::MSG_BATTLE_ATTACK, currentUnit.GetUID(), target.unit->GetUID(), target.unit->GetHeadIndex(), 0 );
 
@@ -547,6 +560,10 @@ namespace AI
         double attackHighestValue = -_enemyArmyStrength;
         double attackPositionValue = -_enemyArmyStrength;
 
+        const bool useLookahead = Settings::Get().ExtBattleAILookahead();
+        std::vector<const Unit *> immediateTargets;
+        std::vector<int32_t> immediateTargetCells;
+
         for ( const Unit * enemy : enemies ) {
             const MeleeAttackOutcome & outcome = BestAttackOutcome( arena, currentUnit, *enemy, *_randomGenerator );
 
@@ -556,6 +573,21 @@ namespace AI
                 target.cell = outcome.fromIndex;
                 target.unit = enemy;
             }
+
+            if ( useLookahead && outcome.canAttackImmediately ) {
+                immediateTargets.push_back( enemy );
+                immediateTargetCells.push_back( outcome.fromIndex );
+            }
+        }
+
+        // Several targets can be attacked right now: the lookahead search knows better which one to choose
+        if ( immediateTargets.size() > 1 ) {
+            const Unit * lookaheadTarget = lookaheadAttackTarget( arena, currentUnit, immediateTargets );
+            if ( lookaheadTarget != nullptr ) {
+                const size_t targetIndex = static_cast<size_t>( std::find( immediateTargets.begin(), immediateTargets.end(), lookaheadTarget ) - immediateTargets.begin() );
+                target.cell = immediateTargetCells[targetIndex];
+                target.unit = lookaheadTarget;
+            }
         }
 
         // For walking units that don't have a target within reach, pick based on distance priority
@@ -761,8 +793,13 @@ namespace AI
         board->Reset();
         board->SetScanPassability( currentUnit );
 
-        const Actions & plannedActions = _battlePlanner.planUnitTurn( arena, currentUnit );
-        actions.insert( actions.end(), plannedActions.begin(), plannedActions.end() );
+        const Game::Benchmark::PhaseTimer timer( Game::Benchmark::Phase::BATTLE_PLANNER );
+
+        // The planner keeps no state between turns. A planner per turn allows battles to run on several threads at the same time.
+        BattlePlanner battlePlanner;
+
+        const Actions & plannedActions = battlePlanner.planUnitTurn( arena, currentUnit );
+        actions.append( plannedActions );
         // Do not end the turn if we only cast a spell
         if ( plannedActions.size() != 1 || !plannedActions.front().isType( CommandType::MSG_BATTLE_CAST ) )
             actions.emplace_back( CommandType::MSG_BATTLE_END_TURN, currentUnit.GetUID() );
@@ -30,6 +30,7 @@
 #include "morale.h"
 #include "mp2.h"
 #include "settings.h"
+#include "thread_pool.h"
 #include "world.h"
 
 namespace
@@ -495,34 +496,14 @@ namespace
         std::map<int, bool> _validObjects;
     };
 
-    // Used for caching of object value estimation per hero.
-    class ObjectValueStorage
+    // Result of an object evaluation which doesn't depend on other objects.
+    struct ObjectEstimation
     {
-    public:
-        ObjectValueStorage( const Heroes & hero, const AI::Normal & ai, const double ignoreValue )
-            : _hero( hero )
-            , _ai( ai )
-            , _ignoreValue( ignoreValue )
-        {}
-
-        double value( const std::pair<int, int> & objectInfo, const uint32_t distance )
-        {
-            auto iter = _objectValue.find( objectInfo );
-            if ( iter != _objectValue.end() ) {
-                return iter->second;
-            }
-
-            const double value = _ai.getObjectValue( _hero, objectInfo.first, _ignoreValue, distance );
-
-            _objectValue[objectInfo] = value;
-            return value;
-        }
-
-    private:
-        const Heroes & _hero;
-        const AI::Normal & _ai;
-        const double _ignoreValue;
-        std::map<std::pair<int, int>, double> _objectValue;
+        bool isValid = false;
+        bool isTarget = false;
+        uint32_t distance = 0;
+        // Value of the object as a destination point.
+        double targetValue = 0;
     };
 
     double getMonsterUpgradeValue( const Army & army, const int monsterId )
@@ -1058,62 +1039,88 @@ namespace AI
 
         const uint32_t leftMovePoints = hero.GetMovePoints();
 
-        ObjectValidator objectValidator( hero, _pathfinder );
-        ObjectValueStorage valueStorage( hero, *this, lowestPossibleValue );
+        const size_t objectCount = _mapObjects.size();
+        std::vector<ObjectEstimation> estimations( objectCount );
 
-        for ( size_t idx = 0; idx < _mapObjects.size(); ++idx ) {
-            const IndexObject & node = _mapObjects[idx];
+        // Objects are evaluated independently in parallel. Every chunk has its own validation cache as the cache isn't thread safe.
+        auto estimateObjects = [this, &hero, &estimations, heroInPatrolMode, patrolIndex, distanceLimit, lowestPossibleValue]( const size_t begin, const size_t end ) {
+            ObjectValidator objectValidator( hero, _pathfinder );
 
-            // Skip if hero in patrol mode and object outside of reach
-            if ( heroInPatrolMode && Maps::GetApproximateDistance( node.first, patrolIndex ) > distanceLimit )
-                continue;
+            for ( size_t idx = begin; idx < end; ++idx ) {
+                const IndexObject & node = _mapObjects[idx];
+
+                if ( !objectValidator.isValid( node.first ) )
+                    continue;
+
+                ObjectEstimation & estimation = estimations[idx];
+                estimation.isValid = true;
 
-            if ( objectValidator.isValid( node.first ) ) {
-                uint32_t dist = _pathfinder.getDistance( node.first );
+                // Skip if hero in patrol mode and object outside of reach
+                if ( heroInPatrolMode && Maps::GetApproximateDistance( node.first, patrolIndex ) > distanceLimit )
+                    continue;
+
+                const uint32_t dist = _pathfinder.getDistance( node.first );
                 if ( dist == 0 )
                     continue;
 
-                double value = valueStorage.value( node, dist );
+                estimation.isTarget = true;
+                estimation.distance = dist;
+                estimation.targetValue = getObjectValue( hero, node.first, lowestPossibleValue, dist );
+            }
+        };
 
-                const std::vector<IndexObject> & list = _pathfinder.getObjectsOnTheWay( node.first );
-                for ( const IndexObject & pair : list ) {
-                    if ( objectValidator.isValid( pair.first ) && std::binary_search( _mapObjects.begin(), _mapObjects.end(), pair ) ) {
-                        const double extraValue = valueStorage.value( pair, 0 ); // object is on the way, we don't loose any movement points.
-                        if ( extraValue > 0 ) {
-                            // There is no need to reduce the quality of the object even if the path has others.
-                            value += extraValue;
-                        }
-                    }
-                }
-                const RegionStats & regionStats = _regions[world.GetTiles( node.first ).GetRegion()];
+        fheroes2::parallelFor( objectCount, estimateObjects );
 
-                if ( heroStrength < regionStats.highestThreat ) {
-                    const Castle * castle = world.getCastleEntrance( Maps::GetPoint( node.first ) );
+        // Values of objects on the way are accumulated along the paths at once instead of tracing the path to every object. Only the objects
+        // lying on some path are evaluated here, each of them once.
+        const std::vector<double> onTheWayValue = _pathfinder.getObjectsOnTheWayValue( [this, &hero, &estimations, lowestPossibleValue]( const IndexObject & object ) {
+            const auto it = std::lower_bound( _mapObjects.begin(), _mapObjects.end(), object );
+            if ( it == _mapObjects.end() || *it != object || !estimations[it - _mapObjects.begin()].isValid )
+                return 0.0;
 
-                    if ( castle && ( castle->GetGarrisonStrength( &hero ) <= 0 || castle->GetColor() == hero.GetColor() ) )
-                        value -= dangerousTaskPenalty / 2;
-                    else
-                        value -= dangerousTaskPenalty;
-                }
+            // No movement points are lost when the object lies on the way to another one. There is no need to reduce the quality of
+            // the object even if the path has others.
+            return std::max( getObjectValue( hero, object.first, lowestPossibleValue, 0 ), 0.0 );
+        } );
 
-                if ( dist > leftMovePoints ) {
-                    // Distant object which is out of reach for the current turn must have lower priority.
-                    dist = leftMovePoints + ( dist - leftMovePoints ) * 2;
-                }
+        for ( size_t idx = 0; idx < objectCount; ++idx ) {
+            const ObjectEstimation & estimation = estimations[idx];
+            if ( !estimation.isTarget )
+                continue;
+
+            const IndexObject & node = _mapObjects[idx];
+            uint32_t dist = estimation.distance;
+
+            double value = estimation.targetValue + onTheWayValue[node.first];
+
+            const RegionStats & regionStats = _regions[world.GetTiles( node.first ).GetRegion()];
 
-                value = ScaleWithDistance( value, dist );
+            if ( heroStrength < regionStats.highestThreat ) {
+                const Castle * castle = world.getCastleEntrance( Maps::GetPoint( node.first ) );
+
+                if ( castle && ( castle->GetGarrisonStrength( &hero ) <= 0 || castle->GetColor() == hero.GetColor() ) )
+                    value -= dangerousTaskPenalty / 2;
+                else
+                    value -= dangerousTaskPenalty;
+            }
 
-                if ( dist && value > maxPriority ) {
-                    maxPriority = value;
-                    priorityTarget = node.first;
+            if ( dist > leftMovePoints ) {
+                // Distant object which is out of reach for the current turn must have lower priority.
+                dist = leftMovePoints + ( dist - leftMovePoints ) * 2;
+            }
+
+            value = ScaleWithDistance( value, dist );
+
+            if ( dist && value > maxPriority ) {
+                maxPriority = value;
+                priorityTarget = node.first;
 #ifdef WITH_DEBUG
-                    objectType = static_cast<MP2::MapObjectType>( node.second );
+                objectType = static_cast<MP2::MapObjectType>( node.second );
 #endif
 
-                    DEBUG_LOG( DBG_AI, DBG_TRACE,
-                               hero.GetName() << ": valid object at " << node.first << " value is " << value << " ("
-                                              << MP2::StringObject( static_cast<MP2::MapObjectType>( node.second ) ) << ")" );
-                }
+                DEBUG_LOG( DBG_AI, DBG_TRACE,
+                           hero.GetName() << ": valid object at " << node.first << " value is " << value << " ("
+                                          << MP2::StringObject( static_cast<MP2::MapObjectType>( node.second ) ) << ")" );
             }
         }
 
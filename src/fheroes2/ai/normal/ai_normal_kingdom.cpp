@@ -184,6 +184,9 @@ namespace AI
 
             const double attackerStrength = enemy->second->GetStrength();
 
+            // distances from this army to all castles are evaluated at once, on demand
+            bool isDistanceFieldEvaluated = false;
+
             for ( size_t idx = 0; idx < castles.size(); ++idx ) {
                 const Castle * castle = castles[idx];
                 if ( castle ) {
@@ -196,7 +199,12 @@ namespace AI
 
                     const double attackerThreat = attackerStrength - defenders;
                     if ( attackerThreat > 0 ) {
-                        const uint32_t dist = _pathfinder.getDistance( enemy->first, castleIndex, color, attackerStrength );
+                        if ( !isDistanceFieldEvaluated ) {
+                            _pathfinder.evaluateDistanceField( enemy->first, color, attackerStrength, threatDistanceLimit );
+                            isDistanceFieldEvaluated = true;
+                        }
+
+                        const uint32_t dist = _pathfinder.getDistance( castleIndex );
                         if ( dist && dist < threatDistanceLimit ) {
                             // castle is under threat
                             castlesInDanger.insert( castleIndex );
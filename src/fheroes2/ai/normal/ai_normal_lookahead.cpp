@@ -0,0 +1,351 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2021                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "ai_normal.h"
+#include "battle_arena.h"
+#include "battle_army.h"
+#include "battle_board.h"
+#include "battle_troop.h"
+#include "logging.h"
+#include "thread_pool.h"
+
+using namespace Battle;
+
+namespace
+{
+    // The search is deepened while the number of searched nodes of a single decision fits into the budget. Unlike a time limit
+    // it gives the same decision on every machine, which matters for deterministic battles and replays.
+    const size_t lookaheadNodeBudget = 200000;
+    const uint32_t lookaheadMaxDepth = 8;
+
+    // Properties of a unit which don't change during the search
+    struct LookaheadUnit
+    {
+        double hitPointsPerMonster = 1;
+        double strengthPerHitPoint = 0;
+        double goodLuckChance = 0;
+        double badLuckChance = 0;
+        double goodMoraleChance = 0;
+        bool isMine = false;
+        bool isShooter = false;
+        bool isTwiceAttack = false;
+        bool ignoreRetaliation = false;
+    };
+
+    // The part of the battle which changes during the search. It doesn't depend on the arena and is cheap to copy.
+    struct LookaheadState
+    {
+        std::vector<double> hitPoints;
+        std::vector<uint8_t> hasRetaliated;
+        // Round of the battle the retaliation flags belong to
+        size_t round = 0;
+    };
+
+    // Simplified battle: units exchange blows without moving, every unit can attack only the units it can reach from its current position.
+    // Luck and morale rolls are chance nodes of the search.
+    class LookaheadModel
+    {
+    public:
+        LookaheadModel( Arena & arena, const Unit & currentUnit, const int myColor, LookaheadState & initialState )
+        {
+            std::vector<const Unit *> & battleUnits = _battleUnits;
+            for ( const Force * force : { &arena.GetForce1(), &arena.GetForce2() } ) {
+                for ( const Unit * unit : *force ) {
+                    if ( unit->isValid() ) {
+                        battleUnits.push_back( unit );
+                    }
+                }
+            }
+
+            // The current unit acts first and the rest of the units act in the order of their speed
+            std::stable_sort( battleUnits.begin(), battleUnits.end(), [&currentUnit]( const Unit * first, const Unit * second ) {
+                if ( first == &currentUnit || second == &currentUnit ) {
+                    return first == &currentUnit && second != &currentUnit;
+                }
+                return first->GetSpeed() > second->GetSpeed();
+            } );
+
+            _size = battleUnits.size();
+            _units.resize( _size );
+            _damagePerMonster.resize( _size * _size, 0.0 );
+            _canAttack.resize( _size * _size, 0 );
+
+            initialState.hitPoints.resize( _size );
+            initialState.hasRetaliated.resize( _size );
+
+            for ( size_t i = 0; i < _size; ++i ) {
+                const Unit & unit = *battleUnits[i];
+                LookaheadUnit & info = _units[i];
+
+                const double hitPoints = unit.GetHitPoints();
+                info.hitPointsPerMonster = std::max( 1u, unit.Monster::GetHitPoints() );
+                info.strengthPerHitPoint = hitPoints > 0 ? unit.GetStrength() / hitPoints : 0;
+                info.isMine = unit.GetCurrentColor() == myColor;
+                info.isShooter = unit.isArchers() && !unit.isHandFighting();
+                info.isTwiceAttack = unit.isTwiceAttack();
+                info.ignoreRetaliation = unit.ignoreRetaliation();
+
+                const int luck = unit.GetLuck();
+                info.goodLuckChance = luck > 0 ? luck / 24.0 : 0;
+                info.badLuckChance = luck < 0 ? -luck / 24.0 : 0;
+
+                const int morale = unit.GetMorale();
+                info.goodMoraleChance = unit.isAffectedByMorale() && morale > 0 ? morale / 24.0 : 0;
+
+                initialState.hitPoints[i] = hitPoints;
+                initialState.hasRetaliated[i] = !unit.AllowResponse();
+
+                const double count = std::max( 1u, unit.GetCount() );
+                const uint32_t reach = unit.GetMoveRange() + 1;
+
+                for ( size_t j = 0; j < _size; ++j ) {
+                    const Unit & target = *battleUnits[j];
+                    if ( unit.GetCurrentColor() == target.GetCurrentColor() ) {
+                        continue;
+                    }
+
+                    _damagePerMonster[i * _size + j] = ( unit.CalculateMinDamage( target ) + unit.CalculateMaxDamage( target ) ) / 2.0 / count;
+
+                    bool canAttack = info.isShooter || unit.isFlying();
+                    for ( const int32_t from : { unit.GetHeadIndex(), unit.GetTailIndex() } ) {
+                        for ( const int32_t to : { target.GetHeadIndex(), target.GetTailIndex() } ) {
+                            canAttack = canAttack || ( Board::isValidIndex( from ) && Board::isValidIndex( to ) && Board::GetDistance( from, to ) <= reach );
+                        }
+                    }
+                    _canAttack[i * _size + j] = canAttack;
+                }
+            }
+        }
+
+        size_t size() const
+        {
+            return _size;
+        }
+
+        // Returns size() if the unit isn't a part of the model
+        size_t indexOf( const Unit & unit ) const
+        {
+            return static_cast<size_t>( std::find( _battleUnits.begin(), _battleUnits.end(), &unit ) - _battleUnits.begin() );
+        }
+
+        const Unit * getUnit( const size_t index ) const
+        {
+            return _battleUnits[index];
+        }
+
+        bool canAttack( const size_t attacker, const size_t target ) const
+        {
+            return _canAttack[attacker * _size + target] != 0;
+        }
+
+        double evaluate( const LookaheadState & state ) const
+        {
+            double value = 0;
+            for ( size_t i = 0; i < _size; ++i ) {
+                const double strength = state.hitPoints[i] * _units[i].strengthPerHitPoint;
+                value += _units[i].isMine ? strength : -strength;
+            }
+            return value;
+        }
+
+        // Expected value of the attack of the given unit followed by the rest of the search
+        double searchAttack( const LookaheadState & state, const size_t attacker, const size_t target, const size_t turnIndex, const uint32_t depth,
+                             size_t & nodes, const size_t nodeLimit ) const
+        {
+            const LookaheadUnit & info = _units[attacker];
+            const double normalLuckChance = 1.0 - info.goodLuckChance - info.badLuckChance;
+
+            double value = 0;
+            for ( const std::pair<double, double> & luck :
+                  { std::make_pair( normalLuckChance, 1.0 ), std::make_pair( info.goodLuckChance, 2.0 ), std::make_pair( info.badLuckChance, 0.5 ) } ) {
+                if ( luck.first <= 0 ) {
+                    continue;
+                }
+
+                LookaheadState next = state;
+                applyAttack( next, attacker, target, luck.second );
+
+                // Good morale gives the unit one more action
+                double outcome = 0;
+                if ( info.goodMoraleChance > 0 ) {
+                    outcome = info.goodMoraleChance * search( next, turnIndex, depth - 1, nodes, nodeLimit )
+                              + ( 1.0 - info.goodMoraleChance ) * search( next, turnIndex + 1, depth - 1, nodes, nodeLimit );
+                }
+                else {
+                    outcome = search( next, turnIndex + 1, depth - 1, nodes, nodeLimit );
+                }
+
+                value += luck.first * outcome;
+            }
+
+            return value;
+        }
+
+    private:
+        void applyAttack( LookaheadState & state, const size_t attacker, const size_t target, const double luckMultiplier ) const
+        {
+            const LookaheadUnit & attackerInfo = _units[attacker];
+            const LookaheadUnit & targetInfo = _units[target];
+
+            const uint32_t strikes = attackerInfo.isTwiceAttack ? 2 : 1;
+            for ( uint32_t strike = 0; strike < strikes && state.hitPoints[attacker] > 0; ++strike ) {
+                const double attackerCount = std::ceil( state.hitPoints[attacker] / attackerInfo.hitPointsPerMonster );
+                const double damage = _damagePerMonster[attacker * _size + target] * attackerCount * luckMultiplier;
+                state.hitPoints[target] = std::max( 0.0, state.hitPoints[target] - damage );
+
+                // Shooters and some monsters don't get retaliation, every unit retaliates once per turn
+                if ( attackerInfo.isShooter || attackerInfo.ignoreRetaliation || state.hitPoints[target] <= 0 || state.hasRetaliated[target] ) {
+                    continue;
+                }
+
+                const double targetCount = std::ceil( state.hitPoints[target] / targetInfo.hitPointsPerMonster );
+                state.hitPoints[attacker] = std::max( 0.0, state.hitPoints[attacker] - _damagePerMonster[target * _size + attacker] * targetCount );
+                state.hasRetaliated[target] = 1;
+            }
+        }
+
+        bool isSideAlive( const LookaheadState & state, const bool isMine ) const
+        {
+            for ( size_t i = 0; i < _size; ++i ) {
+                if ( _units[i].isMine == isMine && state.hitPoints[i] > 0 ) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Expectimax search: my units maximize the value, enemy units minimize it
+        double search( const LookaheadState & state, size_t turnIndex, const uint32_t depth, size_t & nodes, const size_t nodeLimit ) const
+        {
+            if ( depth == 0 || nodes >= nodeLimit || !isSideAlive( state, true ) || !isSideAlive( state, false ) ) {
+                return evaluate( state );
+            }
+
+            ++nodes;
+
+            // Skip the dead units
+            LookaheadState current = state;
+            for ( size_t skipped = 0; current.hitPoints[turnIndex % _size] <= 0 && skipped < _size; ++skipped ) {
+                ++turnIndex;
+            }
+
+            // A new round starts after the last unit: every unit can retaliate again
+            if ( current.round != turnIndex / _size ) {
+                current.round = turnIndex / _size;
+                std::fill( current.hasRetaliated.begin(), current.hasRetaliated.end(), 0 );
+            }
+
+            const size_t attacker = turnIndex % _size;
+            const bool isMine = _units[attacker].isMine;
+
+            bool hasTarget = false;
+            double bestValue = 0;
+
+            for ( size_t target = 0; target < _size; ++target ) {
+                if ( current.hitPoints[target] <= 0 || !canAttack( attacker, target ) ) {
+                    continue;
+                }
+
+                const double value = searchAttack( current, attacker, target, turnIndex, depth, nodes, nodeLimit );
+                if ( !hasTarget || ( isMine ? value > bestValue : value < bestValue ) ) {
+                    bestValue = value;
+                    hasTarget = true;
+                }
+            }
+
+            // The unit can't reach anyone: it just waits for the next turn
+            return hasTarget ? bestValue : search( current, turnIndex + 1, depth - 1, nodes, nodeLimit );
+        }
+
+        size_t _size = 0;
+        std::vector<const Unit *> _battleUnits;
+        std::vector<LookaheadUnit> _units;
+        // Average damage of a single monster of the attacking unit to the target unit: [attacker * size + target]
+        std::vector<double> _damagePerMonster;
+        std::vector<uint8_t> _canAttack;
+    };
+}
+
+namespace AI
+{
+    const Unit * BattlePlanner::lookaheadAttackTarget( Arena & arena, const Unit & currentUnit, const std::vector<const Unit *> & targets ) const
+    {
+        if ( targets.empty() ) {
+            return nullptr;
+        }
+
+        LookaheadState initialState;
+        const LookaheadModel model( arena, currentUnit, _myColor, initialState );
+
+        std::vector<size_t> targetIndexes;
+        for ( const Unit * target : targets ) {
+            const size_t index = model.indexOf( *target );
+            if ( index < model.size() ) {
+                targetIndexes.push_back( index );
+            }
+        }
+
+        if ( targetIndexes.empty() ) {
+            return nullptr;
+        }
+
+        // The current unit is the first one in the model. Targets are searched in parallel, the search is deepened while it fits into the budget.
+        // Every target gets an equal share of the budget and counts its own nodes so the result doesn't depend on the order of the threads.
+        const size_t nodeLimit = lookaheadNodeBudget / targetIndexes.size();
+
+        std::vector<double> bestValues;
+        uint32_t completedDepth = 0;
+
+        for ( uint32_t depth = 1; depth <= lookaheadMaxDepth; ++depth ) {
+            std::vector<double> values( targetIndexes.size(), 0.0 );
+            std::vector<size_t> nodes( targetIndexes.size(), 0 );
+
+            fheroes2::parallelFor( targetIndexes.size(), [&model, &initialState, &targetIndexes, &values, &nodes, nodeLimit, depth]( const size_t begin, const size_t end ) {
+                for ( size_t i = begin; i < end; ++i ) {
+                    values[i] = model.searchAttack( initialState, 0, targetIndexes[i], 0, depth, nodes[i], nodeLimit );
+                }
+            } );
+
+            // Results of an unfinished search are incomplete
+            if ( std::any_of( nodes.begin(), nodes.end(), [nodeLimit]( const size_t count ) { return count >= nodeLimit; } ) ) {
+                break;
+            }
+
+            bestValues = std::move( values );
+            completedDepth = depth;
+        }
+
+        if ( completedDepth == 0 ) {
+            return nullptr;
+        }
+
+        const size_t best = static_cast<size_t>( std::max_element( bestValues.begin(), bestValues.end() ) - bestValues.begin() );
+        const Unit * bestTarget = model.getUnit( targetIndexes[best] );
+
+        DEBUG_LOG( DBG_BATTLE, DBG_TRACE,
+                   currentUnit.GetName() << " lookahead depth " << completedDepth << ", best target " << bestTarget->GetName() << " value " << bestValues[best] );
+
+        return bestTarget;
+    }
+}
@@ -18,6 +18,9 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <array>
+#include <vector>
+
 #include "ai_normal.h"
 #include "battle_arena.h"
 #include "battle_army.h"
@@ -31,6 +34,58 @@ using namespace Battle;
 namespace
 {
     const double antimagicLowLimit = 200.0;
+
+    // Snapshot of all units on the battle board stored as separate arrays. The value of a spell is computed once per unit and
+    // then the values of all units are summed up for every target cell at once in simple loops over the arrays.
+    struct BoardUnits
+    {
+        BoardUnits( Arena & arena, const int myColor )
+        {
+            for ( const Force * force : { &arena.GetForce1(), &arena.GetForce2() } ) {
+                for ( const Unit * unit : *force ) {
+                    if ( !unit->isValid() ) {
+                        continue;
+                    }
+
+                    units.push_back( unit );
+                    headIndexes.push_back( unit->GetHeadIndex() );
+                    tailIndexes.push_back( unit->isWide() ? unit->GetTailIndex() : unit->GetHeadIndex() );
+                    sides.push_back( unit->GetCurrentColor() == myColor ? -1.0 : 1.0 );
+                }
+            }
+        }
+
+        std::vector<const Unit *> units;
+        std::vector<int32_t> headIndexes;
+        std::vector<int32_t> tailIndexes;
+        // -1 for friendly units and 1 for enemy units
+        std::vector<double> sides;
+    };
+
+    // Returns the sum of values of the units affected by an area spell for every target cell. A unit is affected if any of its cells
+    // is within the given distance range from the target cell.
+    std::array<double, ARENASIZE> getAreaSpellCellValues( const BoardUnits & boardUnits, const std::vector<double> & unitValues, const uint32_t minDistance,
+                                                          const uint32_t maxDistance )
+    {
+        std::array<double, ARENASIZE> cellValues;
+        cellValues.fill( 0.0 );
+
+        for ( size_t i = 0; i < boardUnits.units.size(); ++i ) {
+            const double value = unitValues[i] * boardUnits.sides[i];
+
+            const std::array<uint8_t, ARENASIZE> & headDistances = Board::GetDistances( boardUnits.headIndexes[i] );
+            const std::array<uint8_t, ARENASIZE> & tailDistances = Board::GetDistances( boardUnits.tailIndexes[i] );
+
+            for ( size_t cell = 0; cell < ARENASIZE; ++cell ) {
+                const bool isHeadAffected = headDistances[cell] >= minDistance && headDistances[cell] <= maxDistance;
+                const bool isTailAffected = tailDistances[cell] >= minDistance && tailDistances[cell] <= maxDistance;
+
+                cellValues[cell] += ( isHeadAffected || isTailAffected ) ? value : 0.0;
+            }
+        }
+
+        return cellValues;
+    }
 }
 
 namespace AI
@@ -182,10 +237,35 @@ namespace AI
                 }
             }
             else {
-                const Board & board = *Arena::GetBoard();
-                for ( const Cell & cell : board ) {
-                    const int32_t index = cell.GetIndex();
-                    areaOfEffectCheck( arena.GetTargetsForSpells( _commander, spell, index ), index, _myColor );
+                // The same targets as in Arena::GetTargetsForSpells(): the unit in the target cell (except for Cold Ring) and the units around it
+                const uint32_t minDistance = spell.GetID() == Spell::COLDRING ? 1 : 0;
+                uint32_t maxDistance = 0;
+                switch ( spell.GetID() ) {
+                case Spell::FIREBALL:
+                case Spell::METEORSHOWER:
+                case Spell::COLDRING:
+                    maxDistance = 1;
+                    break;
+                case Spell::FIREBLAST:
+                    maxDistance = 2;
+                    break;
+                default:
+                    break;
+                }
+
+                const BoardUnits boardUnits( arena, _myColor );
+
+                std::vector<double> unitValues( boardUnits.units.size(), 0.0 );
+                for ( size_t i = 0; i < boardUnits.units.size(); ++i ) {
+                    const Unit * unit = boardUnits.units[i];
+                    if ( unit->AllowApplySpell( spell, _commander ) ) {
+                        unitValues[i] = damageHeuristic( unit );
+                    }
+                }
+
+                const std::array<double, ARENASIZE> cellValues = getAreaSpellCellValues( boardUnits, unitValues, minDistance, maxDistance );
+                for ( int32_t index = 0; index < ARENASIZE; ++index ) {
+                    bestOutcome.updateOutcome( cellValues[index], index );
                 }
             }
         }
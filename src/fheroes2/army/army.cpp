@@ -51,6 +51,12 @@
 #include "translations.h"
 #include "world.h"
 
+namespace
+{
+    // Global version of army strength values, see Army::InvalidateStrengthCache()
+    std::atomic<uint32_t> strengthCacheVersion( 1 );
+}
+
 enum armysize_t
 {
     ARMY_FEW = 1,
@@ -832,6 +838,9 @@ Army::Army( HeroBase * s )
     : commander( s )
     , combat_format( true )
     , color( Color::NONE )
+    , _strengthVersion( 0 )
+    , _cachedStrengthKey( 0 )
+    , _cachedStrength( 0 )
 {
     reserve( ARMYMAXTROOPS );
     for ( u32 ii = 0; ii < ARMYMAXTROOPS; ++ii )
@@ -842,6 +851,9 @@ Army::Army( const Maps::Tiles & t )
     : commander( nullptr )
     , combat_format( true )
     , color( Color::NONE )
+    , _strengthVersion( 0 )
+    , _cachedStrengthKey( 0 )
+    , _cachedStrength( 0 )
 {
     reserve( ARMYMAXTROOPS );
     for ( u32 ii = 0; ii < ARMYMAXTROOPS; ++ii )
@@ -1116,7 +1128,39 @@ int Army::GetMoraleModificator( std::string * strs ) const
     return result;
 }
 
+void Army::InvalidateStrengthCache()
+{
+    ++strengthCacheVersion;
+}
+
+void Army::InvalidateCachedStrength() const
+{
+    ++_strengthVersion;
+}
+
 double Army::GetStrength() const
+{
+    // The global version is never 0 so a default constructed cache never matches
+    const uint64_t key = ( static_cast<uint64_t>( strengthCacheVersion.load() ) << 32 ) | _strengthVersion.load();
+
+    {
+        const std::lock_guard<std::mutex> lock( _strengthCacheMutex );
+        if ( _cachedStrengthKey == key ) {
+            return _cachedStrength;
+        }
+    }
+
+    const double result = computeStrength();
+
+    // If the army has been changed in the meantime the stored key is already outdated and the value is evaluated again on the next call
+    const std::lock_guard<std::mutex> lock( _strengthCacheMutex );
+    _cachedStrengthKey = key;
+    _cachedStrength = result;
+
+    return result;
+}
+
+double Army::computeStrength() const
 {
     double result = 0;
     const uint32_t archery = ( commander ) ? commander->GetSecondaryValues( Skill::Secondary::ARCHERY ) : 0;
@@ -1198,6 +1242,7 @@ void Army::Reset( bool soft )
 void Army::SetCommander( HeroBase * c )
 {
     commander = c;
+    InvalidateCachedStrength();
 }
 
 HeroBase * Army::GetCommander( void )
@@ -1414,7 +1459,10 @@ bool Army::FastestTroop( const Troop * t1, const Troop * t2 )
 
 void Army::SwapTroops( Troop & t1, Troop & t2 )
 {
-    std::swap( t1, t2 );
+    // Troops can belong to different armies so both are updated through Troop::Set()
+    const Troop temp( t1 );
+    t1.Set( t2 );
+    t2.Set( temp );
 }
 
 bool Army::SaveLastTroop( void ) const
@@ -1472,6 +1520,7 @@ StreamBase & operator>>( StreamBase & msg, Army & army )
 
     // set later from owner (castle, heroes)
     army.commander = nullptr;
+    Army::InvalidateStrengthCache();
 
     return msg;
 }
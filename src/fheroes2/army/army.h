@@ -23,6 +23,8 @@
 #ifndef H2ARMY_H
 #define H2ARMY_H
 
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -141,6 +143,10 @@ public:
 
     static NeutralMonsterJoiningCondition GetJoinSolution( const Heroes &, const Maps::Tiles &, const Troop & );
 
+    // Marks the cached strength of every army as outdated. Used for rare world-wide changes (new day, new turn, end of battle,
+    // artifact transfers); changes of a single army or its commander should use InvalidateCachedStrength() instead.
+    static void InvalidateStrengthCache();
+
     static void DrawMons32Line( const Troops &, s32, s32, u32, u32 = 0, u32 = 0 );
     static void DrawMonsterLines( const Troops & troops, int32_t posX, int32_t posY, uint32_t lineWidth, uint32_t drawPower, bool compact = true,
                                   bool isScouteView = true );
@@ -192,6 +198,10 @@ public:
 
     void resetInvalidMonsters() const;
 
+    // Marks the cached strength of this army as outdated. Must be called whenever a troop of the army, its commander
+    // or anything affecting morale, luck or commander skills is changed.
+    void InvalidateCachedStrength() const;
+
 protected:
     friend StreamBase & operator<<( StreamBase &, const Army & );
     friend StreamBase & operator>>( StreamBase &, Army & );
@@ -199,6 +209,17 @@ protected:
     HeroBase * commander;
     bool combat_format;
     int color;
+
+private:
+    double computeStrength() const;
+
+    // Version of this army, see InvalidateCachedStrength()
+    mutable std::atomic<uint32_t> _strengthVersion;
+
+    // GetStrength() can be called from several threads at once so the cached value and its key are published together under the mutex
+    mutable std::mutex _strengthCacheMutex;
+    mutable uint64_t _cachedStrengthKey;
+    mutable double _cachedStrength;
 };
 
 StreamBase & operator<<( StreamBase &, const Army & );
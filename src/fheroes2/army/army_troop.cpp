@@ -65,17 +65,26 @@ void Troop::Set( const Monster & m, u32 c )
 void Troop::SetMonster( const Monster & m )
 {
     id = m.GetID();
+    onChange();
 }
 
 void Troop::SetCount( u32 c )
 {
     count = c;
+    onChange();
 }
 
 void Troop::Reset( void )
 {
     id = Monster::UNKNOWN;
     count = 0;
+    onChange();
+}
+
+void Troop::Upgrade()
+{
+    Monster::Upgrade();
+    onChange();
 }
 
 const char * Troop::GetName( void ) const
@@ -223,6 +232,12 @@ const Army * ArmyTroop::GetArmy( void ) const
     return army;
 }
 
+void ArmyTroop::onChange()
+{
+    if ( army )
+        army->InvalidateCachedStrength();
+}
+
 std::string ArmyTroop::GetAttackString( void ) const
 {
     if ( Troop::GetAttack() == GetAttack() )
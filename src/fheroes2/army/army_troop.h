@@ -43,6 +43,9 @@ public:
     void SetCount( u32 );
     void Reset( void );
 
+    // Hides Monster::Upgrade() to keep army strength values up to date
+    void Upgrade();
+
     bool isMonster( int ) const;
     const char * GetName( void ) const;
     virtual u32 GetCount( void ) const;
@@ -73,6 +76,9 @@ protected:
     friend StreamBase & operator<<( StreamBase &, const Troop & );
     friend StreamBase & operator>>( StreamBase &, Troop & );
 
+    // Called after the monster or the count of the troop is changed
+    virtual void onChange() {}
+
     u32 count;
 };
 
@@ -100,6 +106,8 @@ public:
     std::string GetDefenseString( void ) const override;
 
 protected:
+    void onChange() override;
+
     const Army * army;
 };
 
@@ -35,7 +35,6 @@
 #include "battle_troop.h"
 #include "kingdom.h"
 #include "logging.h"
-#include "rand.h"
 #include "spell.h"
 #include "tools.h"
 #include "translations.h"
@@ -545,7 +544,7 @@ void Battle::Arena::TargetsApplyDamage( Unit & attacker, const Unit & /*defender
     }
 }
 
-Battle::TargetsInfo Battle::Arena::GetTargetsForDamage( const Unit & attacker, Unit & defender, const int32_t dst, const int dir )
+Battle::TargetsInfo Battle::Arena::GetTargetsForDamage( const Unit & attacker, Unit & defender, const int32_t dst, const int dir ) const
 {
     // The attacked unit should be located on the attacked cell
     assert( defender.GetHeadIndex() == dst || defender.GetTailIndex() == dst );
@@ -560,7 +559,7 @@ Battle::TargetsInfo Battle::Arena::GetTargetsForDamage( const Unit & attacker, U
     res.damage = attacker.GetDamage( defender );
 
     // Genie special attack
-    if ( attacker.GetID() == Monster::GENIE && Rand::Get( 1, 10 ) == 2 && defender.GetHitPoints() / 2 > res.damage ) {
+    if ( attacker.GetID() == Monster::GENIE && _randomGenerator.Get( 1, 10 ) == 2 && defender.GetHitPoints() / 2 > res.damage ) {
         // Replaces the damage, not adding to it
         if ( defender.GetCount() == 1 ) {
             res.damage = defender.GetHitPoints();
@@ -609,7 +608,7 @@ Battle::TargetsInfo Battle::Arena::GetTargetsForDamage( const Unit & attacker, U
     }
     // lich cloud damage
     else if ( attacker.isAbilityPresent( fheroes2::MonsterAbilityType::AREA_SHOT ) && !attacker.isHandFighting() ) {
-        for ( const int32_t aroundIdx : Board::GetAroundIndexes( dst ) ) {
+        for ( const int32_t aroundIdx : Board::GetAroundIndexesView( dst ) ) {
             assert( Board::GetCell( aroundIdx ) != nullptr );
 
             Unit * enemy = Board::GetCell( aroundIdx )->GetUnit();
@@ -664,7 +663,7 @@ std::vector<Battle::Unit *> Battle::Arena::FindChainLightningTargetIndexes( cons
         for ( size_t i = 0; i < foundTroops.size(); ++i ) {
             const int32_t resist = foundTroops[i]->GetMagicResist( Spell::CHAINLIGHTNING, heroSpellPower );
             assert( resist >= 0 );
-            if ( resist < static_cast<int32_t>( Rand::Get( 1, 100 ) ) ) {
+            if ( resist < static_cast<int32_t>( _randomGenerator.Get( 1, 100 ) ) ) {
                 ignoredTroops.push_back( foundTroops[i] );
                 result.push_back( foundTroops[i] );
                 foundTroops.erase( foundTroops.begin() + i );
@@ -1011,13 +1010,13 @@ void Battle::Arena::ApplyActionSpellEarthQuake( const Command & /*cmd*/ )
     const std::vector<int> wallHexPositions = { CASTLE_FIRST_TOP_WALL_POS, CASTLE_SECOND_TOP_WALL_POS, CASTLE_THIRD_TOP_WALL_POS, CASTLE_FOURTH_TOP_WALL_POS };
     for ( int position : wallHexPositions ) {
         if ( 0 != board[position].GetObject() ) {
-            board[position].SetObject( Rand::Get( range.first, range.second ) );
+            board[position].SetObject( static_cast<int>( _randomGenerator.Get( range.first, range.second ) ) );
         }
     }
 
-    if ( towers[0] && towers[0]->isValid() && Rand::Get( 1 ) )
+    if ( towers[0] && towers[0]->isValid() && _randomGenerator.Get( 1 ) )
         towers[0]->SetDestroy();
-    if ( towers[2] && towers[2]->isValid() && Rand::Get( 1 ) )
+    if ( towers[2] && towers[2]->isValid() && _randomGenerator.Get( 1 ) )
         towers[2]->SetDestroy();
 
     DEBUG_LOG( DBG_BATTLE, DBG_TRACE, "spell: " << Spell( Spell::EARTHQUAKE ).GetName() << ", targets: " << targets.size() );
@@ -34,6 +34,7 @@
 #include "battle_cell.h"
 #include "battle_command.h"
 #include "battle_interface.h"
+#include "battle_replay.h"
 #include "battle_tower.h"
 #include "battle_troop.h"
 #include "castle.h"
@@ -49,7 +50,8 @@
 
 namespace Battle
 {
-    Arena * arena = nullptr;
+    // Every thread has its own current battle so independent battles can be simulated on several threads at the same time.
+    thread_local Arena * arena = nullptr;
 }
 
 namespace
@@ -337,7 +339,18 @@ void Battle::Arena::TurnTroop( Unit * troop, const Units & orderHistory )
             _pathfinder.calculate( *troop );
 
             // get task from player
-            if ( troop->isControlRemote() )
+            if ( _replay != nullptr && _isReplayPlayback ) {
+                size_t seed = 0;
+                if ( _replay->getNext( actions, seed ) ) {
+                    // the recorded decision might have been made by the AI which consumes the random generator
+                    _randomGenerator.UpdateSeed( seed );
+                }
+                else {
+                    // the replay is over or doesn't match the battle
+                    end_turn = true;
+                }
+            }
+            else if ( troop->isControlRemote() )
                 RemoteTurn( *troop, actions );
             else {
                 if ( ( troop->GetCurrentControl() & CONTROL_AI ) || ( troop->GetCurrentColor() & auto_battle ) ) {
@@ -347,6 +360,10 @@ void Battle::Arena::TurnTroop( Unit * troop, const Units & orderHistory )
                     HumanTurn( *troop, actions );
                 }
             }
+
+            if ( _replay != nullptr && !_isReplayPlayback ) {
+                _replay->add( actions, _randomGenerator.GetSeed() );
+            }
         }
 
         const size_t newSeed = UpdateRandomSeed( _randomGenerator.GetSeed(), actions );
@@ -671,6 +688,11 @@ bool Battle::Arena::hexIsPassable( int32_t indexTo ) const
     return Board::isValidIndex( indexTo ) && _pathfinder.hexIsPassable( indexTo );
 }
 
+const Battle::CellMask & Battle::Arena::getPassableMask() const
+{
+    return _pathfinder.getPassableMask();
+}
+
 Battle::Indexes Battle::Arena::getAllAvailableMoves( uint32_t moveRange ) const
 {
     return _pathfinder.getAllAvailableMoves( moveRange );
@@ -1284,3 +1306,9 @@ const Rand::DeterministicRandomGenerator & Battle::Arena::GetRandomGenerator() c
 {
     return _randomGenerator;
 }
+
+void Battle::Arena::SetReplay( ReplayTurns * replay, const bool isPlayback )
+{
+    _replay = replay;
+    _isReplayPlayback = isPlayback;
+}
@@ -23,10 +23,9 @@
 #ifndef H2BATTLE_ARENA_H
 #define H2BATTLE_ARENA_H
 
-#include <list>
-
 #include "battle.h"
 #include "battle_board.h"
+#include "battle_command.h"
 #include "battle_grave.h"
 #include "battle_pathfinding.h"
 #include "rand.h"
@@ -42,15 +41,11 @@ namespace Battle
     class Force;
     class Units;
     class Unit;
-    class Command;
     class Tower;
     class Interface;
+    class ReplayTurns;
     class Status;
 
-    class Actions : public std::list<Command>
-    {
-    };
-
     class TroopsUidGenerator
     {
     public:
@@ -120,6 +115,7 @@ namespace Battle
 
         uint32_t CalculateMoveDistance( int32_t indexTo ) const;
         bool hexIsPassable( int32_t indexTo ) const;
+        const CellMask & getPassableMask() const;
         Indexes getAllAvailableMoves( uint32_t moveRange ) const;
         Indexes CalculateTwoMoveOverlap( int32_t indexTo, uint32_t movementRange = 0 ) const;
         Indexes GetPath( const Unit &, const Position & ) const;
@@ -161,6 +157,10 @@ namespace Battle
 
         const Rand::DeterministicRandomGenerator & GetRandomGenerator() const;
 
+        // Decisions of units are recorded into the given replay or, in playback mode, taken from it instead of players and AI
+        void SetReplay( ReplayTurns * replay, const bool isPlayback );
+
+        // Accessors to the battle running on the current thread.
         static Board * GetBoard( void );
         static Tower * GetTower( int );
         static Bridge * GetBridge( void );
@@ -200,7 +200,7 @@ namespace Battle
         void SetCastleTargetValue( int, u32 );
         void CatapultAction( void );
 
-        static TargetsInfo GetTargetsForDamage( const Unit & attacker, Unit & defender, const int32_t dst, const int dir );
+        TargetsInfo GetTargetsForDamage( const Unit & attacker, Unit & defender, const int32_t dst, const int dir ) const;
 
         std::vector<int> GetCastleTargets( void ) const;
         TargetsInfo TargetsForChainLightning( const HeroBase * hero, int32_t attackedTroopIndex );
@@ -256,6 +256,9 @@ namespace Battle
 
         TroopsUidGenerator _uidGenerator;
 
+        ReplayTurns * _replay = nullptr;
+        bool _isReplayPlayback = false;
+
         enum
         {
             CHAIN_LIGHTNING_CREATURE_COUNT = 4
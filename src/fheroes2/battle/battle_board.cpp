@@ -24,7 +24,7 @@
 #include <array>
 #include <cassert>
 #include <cstdint>
-#include <iterator>
+#include <deque>
 #include <set>
 
 #include "battle_arena.h"
@@ -33,6 +33,7 @@
 #include "battle_bridge.h"
 #include "battle_troop.h"
 #include "castle.h"
+#include "game_benchmark.h"
 #include "game_static.h"
 #include "ground.h"
 #include "icn.h"
@@ -73,6 +74,284 @@ namespace
 
         return false;
     }
+
+    uint32_t CalculateDistance( const int32_t index1, const int32_t index2 )
+    {
+        const int32_t x1 = index1 % ARENAW;
+        const int32_t y1 = index1 / ARENAW;
+
+        const int32_t x2 = index2 % ARENAW;
+        const int32_t y2 = index2 / ARENAW;
+
+        const int32_t du = y2 - y1;
+        const int32_t dv = ( x2 + y2 / 2 ) - ( x1 + y1 / 2 );
+
+        if ( ( du >= 0 && dv >= 0 ) || ( du < 0 && dv < 0 ) ) {
+            return std::max( std::abs( du ), std::abs( dv ) );
+        }
+
+        return std::abs( du ) + std::abs( dv );
+    }
+
+    // Hex geometry never changes so distances and directions between all pairs of cells are calculated once. Cell data is
+    // only ~10 KB per table, which easily fits into the CPU cache.
+    using CellPairTable = std::array<std::array<uint8_t, ARENASIZE>, ARENASIZE>;
+
+    const CellPairTable & GetDistanceTable()
+    {
+        static const CellPairTable table = []() {
+            CellPairTable result;
+
+            for ( int32_t index1 = 0; index1 < ARENASIZE; ++index1 ) {
+                for ( int32_t index2 = 0; index2 < ARENASIZE; ++index2 ) {
+                    result[index1][index2] = static_cast<uint8_t>( CalculateDistance( index1, index2 ) );
+                }
+            }
+
+            return result;
+        }();
+
+        return table;
+    }
+
+    const CellPairTable & GetDirectionTable()
+    {
+        static const CellPairTable table = []() {
+            CellPairTable result;
+
+            for ( int32_t index1 = 0; index1 < ARENASIZE; ++index1 ) {
+                result[index1].fill( Battle::UNKNOWN );
+                result[index1][index1] = Battle::CENTER;
+
+                for ( Battle::direction_t dir = Battle::TOP_LEFT; dir < Battle::CENTER; ++dir ) {
+                    if ( Battle::Board::isValidDirection( index1, dir ) ) {
+                        result[index1][Battle::Board::GetIndexDirection( index1, dir )] = static_cast<uint8_t>( dir );
+                    }
+                }
+            }
+
+            return result;
+        }();
+
+        return table;
+    }
+
+    struct CellNeighbours
+    {
+        // Neighbouring cells in the order of directions from TOP_LEFT to LEFT
+        std::array<int32_t, 6> indexes;
+        size_t count = 0;
+
+        Battle::CellMask mask;
+    };
+
+    const std::array<CellNeighbours, ARENASIZE> & GetNeighboursTable()
+    {
+        static const std::array<CellNeighbours, ARENASIZE> table = []() {
+            std::array<CellNeighbours, ARENASIZE> result;
+
+            for ( int32_t index = 0; index < ARENASIZE; ++index ) {
+                CellNeighbours & neighbours = result[index];
+
+                for ( Battle::direction_t dir = Battle::TOP_LEFT; dir < Battle::CENTER; ++dir ) {
+                    if ( Battle::Board::isValidDirection( index, dir ) ) {
+                        const int32_t neighbourIndex = Battle::Board::GetIndexDirection( index, dir );
+
+                        neighbours.indexes[neighbours.count] = neighbourIndex;
+                        ++neighbours.count;
+
+                        neighbours.mask.set( neighbourIndex );
+                    }
+                }
+            }
+
+            return result;
+        }();
+
+        return table;
+    }
+
+    // Returns the mask of all cells of the given board column
+    Battle::CellMask GetColumnMask( const int32_t column )
+    {
+        Battle::CellMask result;
+
+        for ( int32_t row = 0; row < ARENAH; ++row ) {
+            result.set( row * ARENAW + column );
+        }
+
+        return result;
+    }
+
+    // Position of a unit during the path search. For narrow units this is just the index of the head cell, for wide units it's
+    // the index of the head cell and the direction the unit is facing.
+    int32_t GetNodeId( const int32_t headCellId, const bool isLeftDirection )
+    {
+        return headCellId * 2 + ( isLeftDirection ? 1 : 0 );
+    }
+
+    int32_t GetHeadCellId( const int32_t nodeId )
+    {
+        return nodeId / 2;
+    }
+
+    // Only valid for wide units
+    int32_t GetTailCellId( const int32_t nodeId )
+    {
+        return ( nodeId % 2 ) != 0 ? GetHeadCellId( nodeId ) + 1 : GetHeadCellId( nodeId ) - 1;
+    }
+
+    // Only valid for wide units: the same cells with the head and the tail swapped
+    int32_t GetReversedNodeId( const int32_t nodeId )
+    {
+        return GetNodeId( GetTailCellId( nodeId ), ( nodeId % 2 ) == 0 );
+    }
+
+    struct PathNode
+    {
+        bool isReachable() const
+        {
+            return cost != UINT32_MAX || finalCost != UINT32_MAX;
+        }
+
+        // Cost of reaching this position with the ability to move further
+        uint32_t cost = UINT32_MAX;
+        int32_t prevNodeId = -1;
+
+        // Cost of reaching this position when it can only be the end of the path (for example, when the unit enters the moat)
+        uint32_t finalCost = UINT32_MAX;
+        int32_t finalPrevNodeId = -1;
+
+        // Wide units only: the final position is reached by turning back right after the final step, finalPrevNodeId is the reversed position
+        bool isFinalTurnBack = false;
+    };
+
+    // Finds the shortest paths from the current position of the unit to every position reachable within its speed. Turning back
+    // doesn't take any movement points, so this is a 0-1 breadth-first search.
+    std::vector<PathNode> SearchPaths( const Battle::Board & board, const Battle::Unit & unit )
+    {
+        using namespace Battle;
+
+        std::vector<PathNode> nodes( ARENASIZE * 2 );
+
+        const Castle * castle = Arena::GetCastle();
+        const bool isMoatBuilt = castle && castle->isBuild( BUILD_MOAT );
+        const bool isWideUnit = unit.isWide();
+        const uint32_t speed = unit.GetSpeed();
+
+        // Cells free of obstacles and units, the same as Cell::isPassable1( true )
+        const CellMask freeMask = board.GetPassableMask( true );
+
+        std::deque<int32_t> queue;
+
+        auto updateNode = [&nodes, &queue, speed, isWideUnit]( const int32_t nodeId, const uint32_t cost, const int32_t prevNodeId, const bool isFinalStep,
+                                                               const bool isFreeStep ) {
+            if ( cost > speed ) {
+                return;
+            }
+
+            PathNode & node = nodes[nodeId];
+
+            if ( isFinalStep ) {
+                if ( cost < node.finalCost ) {
+                    node.finalCost = cost;
+                    node.finalPrevNodeId = prevNodeId;
+                    node.isFinalTurnBack = false;
+
+                    // Turning back is still possible after the final step as it is not a movement
+                    if ( isWideUnit ) {
+                        const int32_t reversedNodeId = GetReversedNodeId( nodeId );
+                        PathNode & reversedNode = nodes[reversedNodeId];
+
+                        if ( cost < reversedNode.finalCost ) {
+                            reversedNode.finalCost = cost;
+                            reversedNode.finalPrevNodeId = nodeId;
+                            reversedNode.isFinalTurnBack = true;
+                        }
+                    }
+                }
+
+                return;
+            }
+
+            if ( cost >= node.cost ) {
+                return;
+            }
+
+            node.cost = cost;
+            node.prevNodeId = prevNodeId;
+
+            if ( isFreeStep ) {
+                queue.push_front( nodeId );
+            }
+            else {
+                queue.push_back( nodeId );
+            }
+        };
+
+        const int32_t startNodeId = GetNodeId( unit.GetHeadIndex(), isWideUnit && unit.isReflect() );
+
+        nodes[startNodeId].cost = 0;
+        queue.push_back( startNodeId );
+
+        while ( !queue.empty() ) {
+            const int32_t currentNodeId = queue.front();
+            queue.pop_front();
+
+            const int32_t currentHeadCellId = GetHeadCellId( currentNodeId );
+            const uint32_t currentCost = nodes[currentNodeId].cost;
+
+            if ( isWideUnit ) {
+                const bool isCurrentLeftDirection = ( currentNodeId % 2 ) != 0;
+                const int32_t currentTailCellId = GetTailCellId( currentNodeId );
+
+                for ( const int32_t headCellId : Board::GetMoveWideIndexes( currentHeadCellId, isCurrentLeftDirection ) ) {
+                    const int direction = Board::GetDirection( currentHeadCellId, headCellId );
+                    const bool isLeftDirection = ( direction & LEFT_SIDE ) != 0;
+                    const int32_t tailCellId = isLeftDirection ? headCellId + 1 : headCellId - 1;
+
+                    // The same checks as in Cell::isPassable4()
+                    if ( direction == LEFT || direction == RIGHT ) {
+                        if ( !freeMask[headCellId] && headCellId != unit.GetTailIndex() ) {
+                            continue;
+                        }
+                    }
+                    else if ( !freeMask[headCellId] || !Board::isValidDirection( headCellId, isLeftDirection ? RIGHT : LEFT ) || !freeMask[tailCellId] ) {
+                        continue;
+                    }
+
+                    // Turning back is not a movement
+                    const bool isTurnBack = ( headCellId == currentTailCellId );
+
+                    // In the moat it is only allowed to turn back, do not let the unit pass through the moat
+                    bool isFinalStep = false;
+                    if ( isMoatBuilt && ( Board::isMoatIndex( headCellId, unit ) || Board::isMoatIndex( tailCellId, unit ) ) ) {
+                        isFinalStep = ( tailCellId != currentHeadCellId || !Board::isMoatIndex( tailCellId, unit ) )
+                                      && ( headCellId != currentTailCellId || !Board::isMoatIndex( headCellId, unit ) );
+                    }
+
+                    updateNode( GetNodeId( headCellId, isLeftDirection ), isTurnBack ? currentCost : currentCost + 1, currentNodeId, isFinalStep, isTurnBack );
+                }
+            }
+            else {
+                const CellNeighbours & neighbours = GetNeighboursTable()[currentHeadCellId];
+
+                for ( size_t i = 0; i < neighbours.count; ++i ) {
+                    const int32_t cellId = neighbours.indexes[i];
+                    if ( !freeMask[cellId] ) {
+                        continue;
+                    }
+
+                    // Unit steps into the moat, do not let it pass through the moat
+                    const bool isFinalStep = isMoatBuilt && Board::isMoatIndex( cellId, unit );
+
+                    updateNode( GetNodeId( cellId, false ), currentCost + 1, currentNodeId, isFinalStep, false );
+                }
+            }
+        }
+
+        return nodes;
+    }
 }
 
 Battle::Board::Board()
@@ -160,28 +439,23 @@ void Battle::Board::SetEnemyQuality( const Unit & unit ) const
 uint32_t Battle::Board::GetDistance( s32 index1, s32 index2 )
 {
     if ( isValidIndex( index1 ) && isValidIndex( index2 ) ) {
-        const int32_t x1 = index1 % ARENAW;
-        const int32_t y1 = index1 / ARENAW;
-
-        const int32_t x2 = index2 % ARENAW;
-        const int32_t y2 = index2 / ARENAW;
-
-        const int32_t du = y2 - y1;
-        const int32_t dv = ( x2 + y2 / 2 ) - ( x1 + y1 / 2 );
-
-        if ( ( du >= 0 && dv >= 0 ) || ( du < 0 && dv < 0 ) ) {
-            return std::max( std::abs( du ), std::abs( dv ) );
-        }
-        else {
-            return std::abs( du ) + std::abs( dv );
-        }
+        return GetDistanceTable()[index1][index2];
     }
 
     return 0;
 }
 
+const std::array<uint8_t, ARENASIZE> & Battle::Board::GetDistances( const int32_t index )
+{
+    assert( isValidIndex( index ) );
+
+    return GetDistanceTable()[index];
+}
+
 void Battle::Board::SetScanPassability( const Unit & unit )
 {
+    const Game::Benchmark::PhaseTimer timer( Game::Benchmark::Phase::BATTLE_SCAN_PASSABILITY );
+
     std::for_each( begin(), end(), []( Battle::Cell & cell ) { cell.resetReachability(); } );
 
     at( unit.GetHeadIndex() ).setReachableForHead();
@@ -194,8 +468,13 @@ void Battle::Board::SetScanPassability( const Unit & unit )
         const Bridge * bridge = Arena::GetBridge();
         const bool isPassableBridge = bridge == nullptr || bridge->isPassable( unit );
 
+        CellMask reachableMask = GetPlaceableMask( unit );
+        if ( !isPassableBridge ) {
+            reachableMask &= ~GetBridgeMask( unit );
+        }
+
         for ( std::size_t i = 0; i < size(); ++i ) {
-            if ( at( i ).isPassable3( unit, false ) && ( isPassableBridge || !isBridgeIndex( static_cast<int32_t>( i ), unit ) ) ) {
+            if ( reachableMask[i] ) {
                 at( i ).setReachableForHead();
 
                 if ( unit.isWide() ) {
@@ -205,198 +484,60 @@ void Battle::Board::SetScanPassability( const Unit & unit )
         }
     }
     else {
-        // Set passable cells.
-        for ( const int32_t idx : GetDistanceIndexes( unit.GetHeadIndex(), unit.GetSpeed() ) ) {
-            GetPath( unit, Position::GetPositionWhenMoved( unit, idx ), false );
-        }
-    }
-}
-
-bool Battle::Board::GetPathForUnit( const Unit & unit, const Position & destination, const uint32_t remainingSteps, const int32_t currentCellId,
-                                    std::vector<bool> & visitedCells, Indexes & result ) const
-{
-    if ( remainingSteps == 0 ) {
-        return false;
-    }
-
-    const Castle * castle = Arena::GetCastle();
-    const bool isMoatBuilt = castle && castle->isBuild( BUILD_MOAT );
-
-    const int32_t dstCellId = destination.GetHead()->GetIndex();
-
-    // Upper distance limit
-    if ( GetDistance( currentCellId, dstCellId ) > remainingSteps ) {
-        return false;
-    }
-
-    std::multimap<uint32_t, int32_t> cellCosts;
-
-    for ( const int32_t cellId : GetAroundIndexes( currentCellId ) ) {
-        const Cell & cell = at( cellId );
+        const std::vector<PathNode> nodes = SearchPaths( *this, unit );
 
-        // Ignore already visited or impassable cell
-        if ( visitedCells.at( cellId ) || !cell.isPassable4( unit, at( currentCellId ) ) ) {
-            continue;
-        }
-
-        // Unit is already at its destination
-        if ( cellId == dstCellId ) {
-            result.push_back( cellId );
-
-            return true;
-        }
-
-        // Unit steps into the moat, do not let it pass through the moat
-        if ( isMoatBuilt && isMoatIndex( cellId, unit ) ) {
-            continue;
-        }
-
-        // Calculate the distance from the cell in question to the destination, sort cells by distance
-        cellCosts.emplace( GetDistance( cellId, dstCellId ), cellId );
-    }
-
-    // Scan the available cells recursively in ascending order of distance
-    for ( const auto & cellCost : cellCosts ) {
-        const int32_t cellId = cellCost.second;
+        for ( std::size_t nodeId = 0; nodeId < nodes.size(); ++nodeId ) {
+            if ( !nodes[nodeId].isReachable() ) {
+                continue;
+            }
 
-        // Mark the cell as visited for further steps
-        visitedCells.at( cellId ) = true;
+            const int32_t headCellId = GetHeadCellId( static_cast<int32_t>( nodeId ) );
 
-        if ( GetPathForUnit( unit, destination, remainingSteps - 1, cellId, visitedCells, result ) ) {
-            result.push_back( cellId );
+            at( headCellId ).setReachableForHead();
 
-            return true;
+            if ( unit.isWide() ) {
+                at( GetTailCellId( static_cast<int32_t>( nodeId ) ) ).setReachableForTail();
+            }
         }
-
-        // Unmark the cell as visited
-        visitedCells.at( cellId ) = false;
     }
-
-    return false;
 }
 
-bool Battle::Board::GetPathForWideUnit( const Unit & unit, const Position & destination, const uint32_t remainingSteps, const int32_t currentHeadCellId,
-                                        const int32_t prevHeadCellId, std::vector<bool> & visitedCells, Indexes & result ) const
+Battle::CellMask Battle::Board::GetPassableMask( const bool checkUnits ) const
 {
-    if ( remainingSteps == 0 ) {
-        return false;
-    }
-
-    const Castle * castle = Arena::GetCastle();
-    const bool isMoatBuilt = castle && castle->isBuild( BUILD_MOAT );
-
-    const int32_t dstHeadCellId = destination.GetHead()->GetIndex();
-    const int32_t dstTailCellId = destination.GetTail()->GetIndex();
-
-    const bool isCurrentLeftDirection = prevHeadCellId < 0 ? unit.isReflect() : ( ( GetDirection( prevHeadCellId, currentHeadCellId ) & LEFT_SIDE ) != 0 );
-    const int32_t currentTailCellId = isCurrentLeftDirection ? currentHeadCellId + 1 : currentHeadCellId - 1;
-
-    // Upper distance limit
-    if ( GetDistance( currentHeadCellId, dstHeadCellId ) > remainingSteps && GetDistance( currentTailCellId, dstHeadCellId ) > remainingSteps ) {
-        return false;
-    }
-
-    std::multimap<uint32_t, int32_t> cellCosts;
-
-    for ( const int32_t headCellId : GetMoveWideIndexes( currentHeadCellId, isCurrentLeftDirection ) ) {
-        const Cell & cell = at( headCellId );
-
-        // Ignore already visited or impassable cell
-        if ( visitedCells.at( headCellId ) || !cell.isPassable4( unit, at( currentHeadCellId ) ) ) {
-            continue;
-        }
-
-        const int32_t tailCellId = ( GetDirection( currentHeadCellId, headCellId ) & LEFT_SIDE ) ? headCellId + 1 : headCellId - 1;
-
-        // Unit is already at its destination
-        if ( headCellId == dstHeadCellId && tailCellId == dstTailCellId ) {
-            result.push_back( headCellId );
-
-            return true;
-        }
-
-        // Unit is already at its destination, but in the opposite direction
-        if ( headCellId == dstTailCellId && tailCellId == dstHeadCellId ) {
-            result.push_back( tailCellId );
-            result.push_back( headCellId );
-
-            return true;
-        }
-
-        // Unit steps into the moat
-        if ( isMoatBuilt && ( isMoatIndex( headCellId, unit ) || isMoatIndex( tailCellId, unit ) ) ) {
-            // In the moat it is only allowed to turn back, do not let the unit pass through the moat
-            if ( ( tailCellId != currentHeadCellId || !isMoatIndex( tailCellId, unit ) ) && ( headCellId != currentTailCellId || !isMoatIndex( headCellId, unit ) ) ) {
-                continue;
-            }
-        }
-
-        // Calculate the distance from the cell in question to the destination, sort cells by distance
-        cellCosts.emplace( GetDistance( headCellId, dstHeadCellId ) + GetDistance( tailCellId, dstTailCellId ), headCellId );
-    }
-
-    // Scan the available cells recursively in ascending order of distance
-    for ( const auto & cellCost : cellCosts ) {
-        const int32_t headCellId = cellCost.second;
-
-        // Mark the cell as visited for further steps
-        visitedCells.at( headCellId ) = true;
-
-        // Turning back is not a movement
-        const uint32_t steps = headCellId == currentTailCellId ? remainingSteps : remainingSteps - 1;
+    CellMask result;
 
-        if ( GetPathForWideUnit( unit, destination, steps, headCellId, currentHeadCellId, visitedCells, result ) ) {
-            result.push_back( headCellId );
-
-            return true;
+    for ( std::size_t i = 0; i < size(); ++i ) {
+        if ( at( i ).isPassable1( checkUnits ) ) {
+            result.set( i );
         }
-
-        // Unmark the cell as visited
-        visitedCells.at( headCellId ) = false;
     }
 
-    return false;
+    return result;
 }
 
-void Battle::Board::StraightenPathForUnit( const int32_t currentCellId, Indexes & path ) const
+Battle::CellMask Battle::Board::GetPlaceableMask( const Unit & unit ) const
 {
-    // A path less than 2 steps long cannot contain detours, leave it as is
-    if ( path.size() < 2 ) {
-        return;
+    CellMask unitMask;
+    unitMask.set( unit.GetHeadIndex() );
+    if ( unit.isWide() ) {
+        unitMask.set( unit.GetTailIndex() );
     }
 
-    // Remember that the steps in the path are stored in reverse order
-    // Temporarily append the current cell of the unit to the end of the path
-    path.push_back( currentCellId );
-
-    for ( std::size_t curr = 0; path.size() > 2 && curr < path.size() - 2; ++curr ) {
-        const std::size_t next = curr + 1;
-
-        // Check whether we are passing through one of the neighboring cells at any of the future steps (excluding the next step)
-        for ( const int32_t cellId : GetAroundIndexes( path[curr] ) ) {
-            std::size_t pos;
+    const CellMask freeMask = GetPassableMask( true );
 
-            // Search for the last occurence of the current neighboring cell in the path (excluding the next step)
-            // Using path.size() - 1 should be safe here, because, due to the condition in the outer loop, path should never be empty
-            assert( !path.empty() );
-            for ( pos = path.size() - 1; pos > next; --pos ) {
-                if ( path[pos] == cellId ) {
-                    break;
-                }
-            }
+    if ( !unit.isWide() ) {
+        return freeMask | unitMask;
+    }
 
-            // If found, then remove the extra steps
-            if ( pos > next ) {
-                path.erase( path.begin() + next, path.begin() + pos );
+    // A wide unit also needs a free neighbouring cell in the same row for its tail
+    static const CellMask firstColumnMask = GetColumnMask( 0 );
+    static const CellMask lastColumnMask = GetColumnMask( ARENAW - 1 );
 
-                break;
-            }
-        }
-    }
+    const CellMask tailMask = freeMask | unitMask;
+    const CellMask leftTailMask = ( tailMask << 1 ) & ~firstColumnMask;
+    const CellMask rightTailMask = ( tailMask >> 1 ) & ~lastColumnMask;
 
-    // Remove the current cell of the unit from the path
-    assert( !path.empty() );
-    path.pop_back();
+    return ( freeMask & ( leftTailMask | rightTailMask ) ) | unitMask;
 }
 
 Battle::Indexes Battle::Board::GetPath( const Unit & unit, const Position & destination, const bool debug ) const
@@ -413,19 +554,32 @@ Battle::Indexes Battle::Board::GetPath( const Unit & unit, const Position & dest
 
     result.reserve( 15 );
 
-    std::vector<bool> visitedCells( ARENASIZE, false );
+    const std::vector<PathNode> nodes = SearchPaths( *this, unit );
 
-    // Mark the current cell of the unit as visited
-    visitedCells.at( unit.GetHeadIndex() ) = true;
+    const int32_t startNodeId = GetNodeId( unit.GetHeadIndex(), isWideUnit && unit.isReflect() );
+    const int32_t dstHeadCellId = destination.GetHead()->GetIndex();
+    int32_t nodeId = GetNodeId( dstHeadCellId, isWideUnit && destination.GetTail()->GetIndex() > dstHeadCellId );
 
-    if ( isWideUnit ) {
-        GetPathForWideUnit( unit, destination, unit.GetSpeed(), unit.GetHeadIndex(), -1, visitedCells, result );
-    }
-    else {
-        GetPathForUnit( unit, destination, unit.GetSpeed(), unit.GetHeadIndex(), visitedCells, result );
+    if ( nodeId != startNodeId && nodes[nodeId].isReachable() ) {
+        // The destination itself may be reachable only as the final step (for example, in the moat)
+        bool useFinalStep = nodes[nodeId].finalCost < nodes[nodeId].cost;
+
+        // Steps are collected in reverse order
+        while ( nodeId != startNodeId ) {
+            result.push_back( GetHeadCellId( nodeId ) );
+
+            const PathNode & node = nodes[nodeId];
+            if ( useFinalStep ) {
+                // After turning back at the end of the path the final step itself comes next
+                nodeId = node.finalPrevNodeId;
+                useFinalStep = node.isFinalTurnBack;
+            }
+            else {
+                nodeId = node.prevNodeId;
+            }
 
-        // Try to straighten the unit's path by eliminating possible detours
-        StraightenPathForUnit( unit.GetHeadIndex(), result );
+            assert( nodeId >= 0 );
+        }
     }
 
     if ( !result.empty() ) {
@@ -549,12 +703,7 @@ int32_t Battle::Board::OptimalAttackValue( const Unit & attacker, const Unit & t
 int Battle::Board::GetDirection( s32 index1, s32 index2 )
 {
     if ( isValidIndex( index1 ) && isValidIndex( index2 ) ) {
-        if ( index1 == index2 )
-            return CENTER;
-        else
-            for ( direction_t dir = TOP_LEFT; dir < CENTER; ++dir )
-                if ( isValidDirection( index1, dir ) && index2 == GetIndexDirection( index1, dir ) )
-                    return dir;
+        return GetDirectionTable()[index1][index2];
     }
 
     return UNKNOWN;
@@ -562,7 +711,7 @@ int Battle::Board::GetDirection( s32 index1, s32 index2 )
 
 bool Battle::Board::isNearIndexes( s32 index1, s32 index2 )
 {
-    return index1 != index2 && UNKNOWN != GetDirection( index1, index2 );
+    return isValidIndex( index1 ) && isValidIndex( index2 ) && ( GetDirectionTable()[index1][index2] & AROUND ) != 0;
 }
 
 int Battle::Board::GetReflectDirection( int d )
@@ -1033,11 +1182,15 @@ Battle::Indexes Battle::Board::GetAroundIndexes( s32 center, s32 ignore )
     Indexes result;
 
     if ( isValidIndex( center ) ) {
-        result.reserve( 12 );
+        const CellNeighbours & neighbours = GetNeighboursTable()[center];
 
-        for ( direction_t dir = TOP_LEFT; dir < CENTER; ++dir )
-            if ( isValidDirection( center, dir ) && GetIndexDirection( center, dir ) != ignore )
-                result.push_back( GetIndexDirection( center, dir ) );
+        result.reserve( neighbours.count );
+
+        for ( size_t i = 0; i < neighbours.count; ++i ) {
+            if ( neighbours.indexes[i] != ignore ) {
+                result.push_back( neighbours.indexes[i] );
+            }
+        }
     }
 
     return result;
@@ -1068,38 +1221,75 @@ Battle::Indexes Battle::Board::GetAroundIndexes( const Position & position )
     return GetAroundIndexes( headIdx );
 }
 
-Battle::Indexes Battle::Board::GetDistanceIndexes( s32 center, u32 radius )
+Battle::IndexesView Battle::Board::GetAroundIndexesView( const int32_t center )
 {
-    Indexes result;
+    if ( !isValidIndex( center ) ) {
+        return IndexesView( nullptr, nullptr );
+    }
 
-    if ( isValidIndex( center ) ) {
-        std::set<s32> st;
-        Indexes abroad;
+    const CellNeighbours & neighbours = GetNeighboursTable()[center];
 
-        st.insert( center );
-        abroad.push_back( center );
+    return IndexesView( neighbours.indexes.data(), neighbours.indexes.data() + neighbours.count );
+}
 
-        while ( !abroad.empty() && radius ) {
-            std::set<s32> tm = st;
+const Battle::CellMask & Battle::Board::GetAroundMask( const int32_t center )
+{
+    static const CellMask emptyMask;
 
-            for ( Indexes::const_iterator it = abroad.begin(); it != abroad.end(); ++it ) {
-                const Indexes around = GetAroundIndexes( *it );
-                tm.insert( around.begin(), around.end() );
-            }
+    return isValidIndex( center ) ? GetNeighboursTable()[center].mask : emptyMask;
+}
+
+Battle::CellMask Battle::Board::GetAroundMask( const Unit & unit )
+{
+    CellMask result = GetAroundMask( unit.GetHeadIndex() );
+
+    if ( unit.isWide() ) {
+        result |= GetAroundMask( unit.GetTailIndex() );
+        result.reset( unit.GetHeadIndex() );
+        result.reset( unit.GetTailIndex() );
+    }
+
+    return result;
+}
+
+Battle::CellMask Battle::Board::GetMoatMask( const Unit & unit )
+{
+    CellMask result;
 
-            abroad.resize( tm.size() );
+    for ( const int32_t index : { 7, 18, 28, 39, 49, 61, 72, 84, 95 } ) {
+        if ( isMoatIndex( index, unit ) ) {
+            result.set( index );
+        }
+    }
 
-            Indexes::iterator abroad_end = std::set_difference( tm.begin(), tm.end(), st.begin(), st.end(), abroad.begin() );
+    return result;
+}
 
-            abroad.resize( std::distance( abroad.begin(), abroad_end ) );
+Battle::CellMask Battle::Board::GetBridgeMask( const Unit & unit )
+{
+    CellMask result;
 
-            st.swap( tm );
-            --radius;
+    for ( const int32_t index : { 49, 50 } ) {
+        if ( isBridgeIndex( index, unit ) ) {
+            result.set( index );
         }
+    }
+
+    return result;
+}
 
-        st.erase( center );
-        result.reserve( st.size() );
-        std::copy( st.begin(), st.end(), std::back_inserter( result ) );
+Battle::Indexes Battle::Board::GetDistanceIndexes( s32 center, u32 radius )
+{
+    Indexes result;
+
+    if ( isValidIndex( center ) ) {
+        const std::array<uint8_t, ARENASIZE> & distances = GetDistanceTable()[center];
+
+        for ( int32_t index = 0; index < ARENASIZE; ++index ) {
+            if ( index != center && distances[index] <= radius ) {
+                result.push_back( index );
+            }
+        }
     }
 
     return result;
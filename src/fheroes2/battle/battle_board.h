@@ -23,6 +23,8 @@
 #ifndef H2BATTLE_BOARD_H
 #define H2BATTLE_BOARD_H
 
+#include <array>
+#include <bitset>
 #include <random>
 
 #include "battle_cell.h"
@@ -49,6 +51,43 @@ namespace Battle
 
     using Indexes = std::vector<int32_t>;
 
+    // Set of battlefield cells, one bit per cell index. The whole board fits into two machine words.
+    using CellMask = std::bitset<ARENASIZE>;
+
+    // Read-only view of cell indexes stored elsewhere, used to avoid allocations in lookups of precomputed data
+    class IndexesView
+    {
+    public:
+        IndexesView( const int32_t * first, const int32_t * last )
+            : _first( first )
+            , _last( last )
+        {}
+
+        const int32_t * begin() const
+        {
+            return _first;
+        }
+
+        const int32_t * end() const
+        {
+            return _last;
+        }
+
+        size_t size() const
+        {
+            return static_cast<size_t>( _last - _first );
+        }
+
+        bool empty() const
+        {
+            return _first == _last;
+        }
+
+    private:
+        const int32_t * _first;
+        const int32_t * _last;
+    };
+
     class Board : public std::vector<Cell>
     {
     public:
@@ -66,6 +105,11 @@ namespace Battle
         void SetPositionQuality( const Unit & ) const;
         void SetScanPassability( const Unit & );
 
+        // Returns the mask of cells free of obstacles and, if checkUnits is true, of units
+        CellMask GetPassableMask( const bool checkUnits ) const;
+        // Returns the mask of cells where the given unit can be placed (with any direction for wide units), see Cell::isPassable3()
+        CellMask GetPlaceableMask( const Unit & unit ) const;
+
         void SetCobjObjects( const Maps::Tiles & tile, std::mt19937 & gen );
         void SetCovrObjects( int icn );
 
@@ -88,13 +132,21 @@ namespace Battle
         static int32_t OptimalAttackTarget( const Unit & attacker, const Unit & target, const int32_t from );
         static int32_t OptimalAttackValue( const Unit & attacker, const Unit & target, const int32_t from );
         static uint32_t GetDistance( s32, s32 );
+        // Distances from the cell with the given (valid) index to every cell of the board
+        static const std::array<uint8_t, ARENASIZE> & GetDistances( const int32_t index );
         static bool isValidDirection( s32, int );
         static s32 GetIndexDirection( s32, int );
         static Indexes GetDistanceIndexes( s32, u32 );
         static Indexes GetAroundIndexes( s32 center, s32 ignore = -1 );
+        // The same as GetAroundIndexes( center ) but without a copy of the precomputed data
+        static IndexesView GetAroundIndexesView( const int32_t center );
         static Indexes GetAroundIndexes( const Unit & unit );
         static Indexes GetAroundIndexes( const Position & position );
         static Indexes GetMoveWideIndexes( s32, bool reflect );
+        static const CellMask & GetAroundMask( const int32_t center );
+        static CellMask GetAroundMask( const Unit & unit );
+        static CellMask GetMoatMask( const Unit & unit );
+        static CellMask GetBridgeMask( const Unit & unit );
         static bool isValidMirrorImageIndex( s32, const Unit * );
 
         // Checks that the current unit (to which the current passability information relates) is able (in principle)
@@ -113,12 +165,6 @@ namespace Battle
 
     private:
         void SetCobjObject( const int icn, const int32_t dst );
-
-        bool GetPathForUnit( const Unit & unit, const Position & destination, const uint32_t remainingSteps, const int32_t currentCellId,
-                             std::vector<bool> & visitedCells, Indexes & result ) const;
-        bool GetPathForWideUnit( const Unit & unit, const Position & destination, const uint32_t remainingSteps, const int32_t currentHeadCellId,
-                                 const int32_t prevHeadCellId, std::vector<bool> & visitedCells, Indexes & result ) const;
-        void StraightenPathForUnit( const int32_t currentCellId, Indexes & path ) const;
     };
 }
 
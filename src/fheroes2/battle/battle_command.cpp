@@ -25,19 +25,27 @@
 
 Battle::Command::Command( const CommandType cmd )
     : _type( cmd )
+    , _params()
+    , _paramsCount( 0 )
 {}
 
 Battle::Command & Battle::Command::operator<<( const int val )
 {
-    push_back( val );
+    assert( _paramsCount < MAX_PARAMS_COUNT );
+
+    if ( _paramsCount < MAX_PARAMS_COUNT ) {
+        _params[_paramsCount] = val;
+        ++_paramsCount;
+    }
+
     return *this;
 }
 
 Battle::Command & Battle::Command::operator>>( int & val )
 {
-    if ( !empty() ) {
-        val = back();
-        pop_back();
+    if ( _paramsCount > 0 ) {
+        --_paramsCount;
+        val = _params[_paramsCount];
     }
     return *this;
 }
@@ -50,7 +58,7 @@ int Battle::Command::GetValue( void )
 }
 
 Battle::Command::Command( const CommandType cmd, const int param1, const int param2 /* = -1 */, const int param3 /* = -1 */, const int param4 /* = -1 */ )
-    : _type( cmd )
+    : Command( cmd )
 {
     switch ( _type ) {
     case CommandType::MSG_BATTLE_AUTO:
@@ -108,3 +116,42 @@ Battle::Command::Command( const CommandType cmd, const int param1, const int par
         break;
     }
 }
+
+void Battle::Actions::push_back( const Command & command )
+{
+    if ( _heapCommands.empty() ) {
+        if ( _last < INLINE_CAPACITY ) {
+            _inlineCommands[_last] = command;
+            ++_last;
+            return;
+        }
+
+        // No more space in place, move all commands to the heap
+        _heapCommands.reserve( INLINE_CAPACITY * 2 );
+        _heapCommands.assign( _inlineCommands.begin(), _inlineCommands.end() );
+    }
+
+    _heapCommands.push_back( command );
+    ++_last;
+}
+
+void Battle::Actions::append( const Actions & actions )
+{
+    for ( const Command & command : actions ) {
+        push_back( command );
+    }
+}
+
+void Battle::Actions::pop_front()
+{
+    assert( !empty() );
+
+    ++_first;
+
+    // Reuse the storage from the beginning once the queue is empty
+    if ( _first == _last ) {
+        _first = 0;
+        _last = 0;
+        _heapCommands.clear();
+    }
+}
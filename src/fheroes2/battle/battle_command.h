@@ -23,7 +23,11 @@
 #ifndef H2BATTLE_COMMAND_H
 #define H2BATTLE_COMMAND_H
 
+#include <array>
+#include <cassert>
 #include <functional>
+#include <utility>
+#include <vector>
 
 #include "battle_board.h"
 
@@ -44,9 +48,22 @@ namespace Battle
         MSG_BATTLE_AUTO
     };
 
-    class Command : public std::vector<int>
+    // Parameters of a command are stored in place because commands are created for every action of every unit and
+    // heap allocations would dominate the cost of the simulated battles
+    class Command
     {
     public:
+        // The longest command is the catapult attack: the number of shots and three values for each of up to four shots
+        enum : size_t
+        {
+            MAX_PARAMS_COUNT = 13
+        };
+
+        // Creates an empty command, only used to reserve space in containers
+        Command()
+            : Command( CommandType::MSG_BATTLE_END_TURN )
+        {}
+
         explicit Command( const CommandType cmd );
         Command( const CommandType cmd, const int param1, const int param2 = -1, const int param3 = -1, const int param4 = -1 );
 
@@ -65,8 +82,112 @@ namespace Battle
         Command & operator<<( const int );
         Command & operator>>( int & );
 
+        // Parameters are stored in the order they were added and extracted from the back
+        const int * begin() const
+        {
+            return _params.data();
+        }
+
+        const int * end() const
+        {
+            return _params.data() + _paramsCount;
+        }
+
+        int * begin()
+        {
+            return _params.data();
+        }
+
+        int * end()
+        {
+            return _params.data() + _paramsCount;
+        }
+
+        size_t size() const
+        {
+            return _paramsCount;
+        }
+
+        bool empty() const
+        {
+            return _paramsCount == 0;
+        }
+
     private:
         CommandType _type;
+        std::array<int, MAX_PARAMS_COUNT> _params;
+        size_t _paramsCount;
+    };
+
+    // Queue of commands of a unit turn. A turn usually consists of a few commands so they are kept in place and
+    // only a very long sequence of commands is moved to the heap.
+    class Actions
+    {
+    public:
+        enum : size_t
+        {
+            INLINE_CAPACITY = 8
+        };
+
+        bool empty() const
+        {
+            return _first == _last;
+        }
+
+        size_t size() const
+        {
+            return _last - _first;
+        }
+
+        const Command * begin() const
+        {
+            return data() + _first;
+        }
+
+        const Command * end() const
+        {
+            return data() + _last;
+        }
+
+        const Command & front() const
+        {
+            assert( !empty() );
+            return data()[_first];
+        }
+
+        Command & front()
+        {
+            assert( !empty() );
+            return data()[_first];
+        }
+
+        void push_back( const Command & command );
+
+        template <typename... Types>
+        void emplace_back( Types &&... args )
+        {
+            push_back( Command( std::forward<Types>( args )... ) );
+        }
+
+        void append( const Actions & actions );
+
+        void pop_front();
+
+    private:
+        const Command * data() const
+        {
+            return _heapCommands.empty() ? _inlineCommands.data() : _heapCommands.data();
+        }
+
+        Command * data()
+        {
+            return _heapCommands.empty() ? _inlineCommands.data() : _heapCommands.data();
+        }
+
+        std::array<Command, INLINE_CAPACITY> _inlineCommands;
+        std::vector<Command> _heapCommands;
+        size_t _first = 0;
+        size_t _last = 0;
     };
 }
 
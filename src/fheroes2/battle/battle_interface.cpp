@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 #include "agg.h"
 #include "agg_image.h"
@@ -180,6 +181,61 @@ namespace
             }
         }
     }
+
+    bool isRowChanged( const uint8_t * current, const uint8_t * previous, const int32_t width )
+    {
+        return std::memcmp( current, previous, static_cast<size_t>( width ) ) != 0;
+    }
+
+    // Returns the bounding rectangle of pixels which differ in two images of the same size, an empty rectangle if the images are the same
+    fheroes2::Rect getChangedArea( const fheroes2::Image & current, const fheroes2::Image & previous )
+    {
+        assert( current.width() == previous.width() && current.height() == previous.height() );
+
+        const int32_t width = current.width();
+        const int32_t height = current.height();
+        const bool checkTransform = !current.singleLayer() && !previous.singleLayer();
+
+        int32_t minX = width;
+        int32_t maxX = -1;
+        int32_t minY = height;
+        int32_t maxY = -1;
+
+        for ( int32_t y = 0; y < height; ++y ) {
+            const size_t offset = static_cast<size_t>( y ) * width;
+            const uint8_t * currentImage = current.image() + offset;
+            const uint8_t * previousImage = previous.image() + offset;
+            const uint8_t * currentTransform = checkTransform ? current.transform() + offset : nullptr;
+            const uint8_t * previousTransform = checkTransform ? previous.transform() + offset : nullptr;
+
+            if ( !isRowChanged( currentImage, previousImage, width ) && ( !checkTransform || !isRowChanged( currentTransform, previousTransform, width ) ) ) {
+                continue;
+            }
+
+            minY = std::min( minY, y );
+            maxY = y;
+
+            for ( int32_t x = 0; x < minX; ++x ) {
+                if ( currentImage[x] != previousImage[x] || ( checkTransform && currentTransform[x] != previousTransform[x] ) ) {
+                    minX = x;
+                    break;
+                }
+            }
+
+            for ( int32_t x = width - 1; x > maxX; --x ) {
+                if ( currentImage[x] != previousImage[x] || ( checkTransform && currentTransform[x] != previousTransform[x] ) ) {
+                    maxX = x;
+                    break;
+                }
+            }
+        }
+
+        if ( maxY < 0 || maxX < minX ) {
+            return fheroes2::Rect();
+        }
+
+        return fheroes2::Rect( minX, minY, maxX - minX + 1, maxY - minY + 1 );
+    }
 }
 
 namespace Battle
@@ -1106,6 +1162,7 @@ void Battle::Interface::fullRedraw()
         _background.reset( new fheroes2::StandardWindow( fheroes2::Display::DEFAULT_WIDTH, fheroes2::Display::DEFAULT_HEIGHT ) );
     }
 
+    _isFullRenderRequired = true;
     Redraw();
 }
 
@@ -1144,7 +1201,34 @@ void Battle::Interface::RedrawPartialFinish()
     fheroes2::Blit( _mainSurface, display, _interfacePosition.x, _interfacePosition.y );
     RedrawInterface();
 
-    display.render();
+    if ( _isFullRenderRequired || _previousFrame.width() != _mainSurface.width() || _previousFrame.height() != _mainSurface.height() ) {
+        _isFullRenderRequired = false;
+        display.render();
+    }
+    else if ( listlog && listlog->isOpenLog() ) {
+        display.render( _interfacePosition );
+    }
+    else {
+        // Status bar and buttons are drawn directly on the screen, they are always rendered together with the changed part of the battlefield
+        const int32_t bottomY = btn_auto.area().y;
+        fheroes2::Rect roi( _interfacePosition.x, bottomY, _interfacePosition.width, _interfacePosition.y + _interfacePosition.height - bottomY );
+
+        fheroes2::Rect changedArea = getChangedArea( _mainSurface, _previousFrame );
+        if ( changedArea.width > 0 && changedArea.height > 0 ) {
+            changedArea.x += _interfacePosition.x;
+            changedArea.y += _interfacePosition.y;
+            roi = fheroes2::getBoundaryRect( roi, changedArea );
+        }
+
+        const fheroes2::Rect & popupArea = popup.GetArea();
+        if ( popupArea.width > 0 && popupArea.height > 0 ) {
+            roi = fheroes2::getBoundaryRect( roi, popupArea );
+        }
+
+        display.render( roi );
+    }
+
+    _previousFrame = _mainSurface;
 }
 
 void Battle::Interface::RedrawInterface( void )
@@ -1761,6 +1845,34 @@ void Battle::Interface::RedrawCover()
 }
 
 void Battle::Interface::RedrawCoverStatic( const Settings & conf, const Board & board )
+{
+    std::vector<int> boardObjects;
+    boardObjects.reserve( board.size() );
+    for ( const Cell & cell : board ) {
+        boardObjects.push_back( cell.GetObject() );
+    }
+
+    if ( _staticBackground.empty() || boardObjects != _staticBackgroundObjects || conf.BattleShowGrid() != _isStaticBackgroundGrid ) {
+        RedrawStaticBackground( conf, board );
+
+        _staticBackground = _mainSurface;
+        _staticBackgroundObjects = std::move( boardObjects );
+        _isStaticBackgroundGrid = conf.BattleShowGrid();
+    }
+    else {
+        fheroes2::Copy( _staticBackground, _mainSurface );
+    }
+
+    if ( !_movingUnit && conf.BattleShowMoveShadow() && _currentUnit && !( _currentUnit->GetCurrentControl() & CONTROL_AI ) ) { // shadow
+        for ( const Cell & cell : board ) {
+            if ( cell.isReachableForHead() || cell.isReachableForTail() ) {
+                fheroes2::Blit( sf_shadow, _mainSurface, cell.GetPos().x, cell.GetPos().y );
+            }
+        }
+    }
+}
+
+void Battle::Interface::RedrawStaticBackground( const Settings & conf, const Board & board )
 {
     if ( icn_cbkg != ICN::UNKNOWN ) {
         const fheroes2::Sprite & cbkg = fheroes2::AGG::GetICN( icn_cbkg, 0 );
@@ -1791,14 +1903,6 @@ void Battle::Interface::RedrawCoverStatic( const Settings & conf, const Board &
     const Castle * castle = Arena::GetCastle();
     if ( castle )
         RedrawCastle1( *castle );
-
-    if ( !_movingUnit && conf.BattleShowMoveShadow() && _currentUnit && !( _currentUnit->GetCurrentControl() & CONTROL_AI ) ) { // shadow
-        for ( const Cell & cell : board ) {
-            if ( cell.isReachableForHead() || cell.isReachableForTail() ) {
-                fheroes2::Blit( sf_shadow, _mainSurface, cell.GetPos().x, cell.GetPos().y );
-            }
-        }
-    }
 }
 
 void Battle::Interface::RedrawCastle1( const Castle & castle )
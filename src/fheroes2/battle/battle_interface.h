@@ -251,6 +251,7 @@ namespace Battle
 
         void RedrawCover( void );
         void RedrawCoverStatic( const Settings & conf, const Board & board );
+        void RedrawStaticBackground( const Settings & conf, const Board & board );
         void RedrawLowObjects( s32 );
         void RedrawHighObjects( s32 );
         void RedrawCastle1( const Castle & );
@@ -376,6 +377,15 @@ namespace Battle
         };
 
         BridgeMovementAnimation _bridgeAnimation;
+
+        // The background, ground obstacles and castle base are redrawn only when the objects on the board or the grid setting change
+        fheroes2::Image _staticBackground;
+        std::vector<int> _staticBackgroundObjects;
+        bool _isStaticBackgroundGrid = false;
+
+        // The previous frame of the battlefield: only the area which differs from it is rendered on the screen
+        fheroes2::Image _previousFrame;
+        bool _isFullRenderRequired = true;
     };
 }
 
@@ -28,8 +28,10 @@
 #include "artifact.h"
 #include "battle_arena.h"
 #include "battle_army.h"
+#include "battle_replay.h"
 #include "dialog.h"
 #include "game.h"
+#include "game_benchmark.h"
 #include "heroes_base.h"
 #include "kingdom.h"
 #include "logging.h"
@@ -155,6 +157,8 @@ namespace
 
 Battle::Result Battle::Loader( Army & army1, Army & army2, s32 mapsindex )
 {
+    const Game::Benchmark::PhaseTimer timer( Game::Benchmark::Phase::BATTLE );
+
     Result result;
 
     // Validate the arguments - check if battle should even load
@@ -210,11 +214,23 @@ Battle::Result Battle::Loader( Army & army1, Army & army2, s32 mapsindex )
     const size_t battleSeed = Settings::Get().ExtBattleDeterministicResult() ? computeBattleSeed( mapsindex, world.GetMapSeed(), army1, army2 )
                                                                              : Rand::Get( std::numeric_limits<uint32_t>::max() );
 
+    // The state of the world has to be saved before the arena is created
+    std::unique_ptr<ReplayRecorder> replayRecorder;
+    if ( isReplayRecordingEnabled() ) {
+        replayRecorder.reset( new ReplayRecorder( army1, army2, mapsindex, battleSeed ) );
+    }
+
     bool isBattleOver = false;
     while ( !isBattleOver ) {
         Rand::DeterministicRandomGenerator randomGenerator( battleSeed );
         Arena arena( army1, army2, mapsindex, showBattle, randomGenerator );
 
+        if ( replayRecorder ) {
+            // only the last attempt of the battle is recorded
+            replayRecorder->getTurns().clear();
+            arena.SetReplay( &replayRecorder->getTurns(), false );
+        }
+
         DEBUG_LOG( DBG_BATTLE, DBG_INFO, "army1 " << army1.String() );
         DEBUG_LOG( DBG_BATTLE, DBG_INFO, "army2 " << army2.String() );
 
@@ -253,6 +269,10 @@ Battle::Result Battle::Loader( Army & army1, Army & army2, s32 mapsindex )
         }
         isBattleOver = true;
 
+        if ( replayRecorder ) {
+            replayRecorder->save( arena );
+        }
+
         if ( loserHero != nullptr && loserAbandoned ) {
             // if a hero lost the battle and didn't flee or surrender, they lose all artifacts
             clearArtifacts( loserHero->GetBagArtifacts() );
@@ -320,6 +340,9 @@ Battle::Result Battle::Loader( Army & army1, Army & army2, s32 mapsindex )
             army2.Reset( false );
     }
 
+    // Spell points, artifacts and troop counts of both sides have been changed
+    Army::InvalidateStrengthCache();
+
     DEBUG_LOG( DBG_BATTLE, DBG_INFO, "army1: " << ( result.army1 & RESULT_WINS ? "wins" : "loss" ) << ", army2: " << ( result.army2 & RESULT_WINS ? "wins" : "loss" ) );
 
     return result;
@@ -24,6 +24,8 @@
 #include "agg_image.h"
 #include "army_bar.h"
 #include "battle.h"
+#include "castle.h"
+#include "castle_heroes.h"
 #include "cursor.h"
 #include "dialog.h"
 #include "dialog_selectitems.h"
@@ -31,6 +33,7 @@
 #include "heroes.h"
 #include "heroes_indicator.h"
 #include "icn.h"
+#include "maps.h"
 #include "race.h"
 #include "settings.h"
 #include "skill_bar.h"
@@ -44,6 +47,116 @@
 namespace
 {
     const uint32_t primaryMaxValue = 20;
+
+    struct BenchmarkTroop
+    {
+        int monster;
+        uint32_t count;
+    };
+
+    struct BenchmarkSide
+    {
+        // Heroes::UNKNOWN means that the troops fight without a hero: as wandering monsters or as a castle garrison.
+        int heroId;
+        int attack;
+        int defense;
+        int power;
+        int knowledge;
+        std::vector<int> spells;
+        std::vector<BenchmarkTroop> troops;
+    };
+
+    struct BenchmarkBattle
+    {
+        const char * name;
+        bool isSiege;
+        BenchmarkSide attacker;
+        BenchmarkSide defender;
+    };
+
+    const std::vector<BenchmarkBattle> & getBenchmarkBattles()
+    {
+        static const std::vector<BenchmarkBattle> battles = {
+            { "Wide vs narrow units", false,
+              { Heroes::LORDKILBURN, 5, 5, 2, 2, {}, { { Monster::CAVALRY, 30 }, { Monster::CHAMPION, 20 }, { Monster::UNICORN, 10 }, { Monster::CYCLOPS, 6 } } },
+              { Heroes::THUNDAX, 5, 5, 2, 2, {}, { { Monster::PIKEMAN, 60 }, { Monster::SWORDSMAN, 50 }, { Monster::GOBLIN, 120 }, { Monster::BATTLE_DWARF, 40 } } } },
+            { "Archers vs flyers", false,
+              { Heroes::ASTRA, 4, 6, 2, 2, {}, { { Monster::RANGER, 60 }, { Monster::GRAND_ELF, 40 }, { Monster::ORC_CHIEF, 40 }, { Monster::TITAN, 3 } } },
+              { Heroes::ARIE, 6, 4, 2, 2, {}, { { Monster::GARGOYLE, 50 }, { Monster::GRIFFIN, 30 }, { Monster::VAMPIRE_LORD, 20 }, { Monster::PHOENIX, 4 } } } },
+            { "Mass spellcasting", false,
+              { Heroes::MYRA, 3, 3, 12, 12, { Spell::FIREBALL, Spell::CHAINLIGHTNING, Spell::METEORSHOWER, Spell::COLDRING, Spell::MASSHASTE, Spell::BLIND },
+                { { Monster::MAGE, 30 }, { Monster::IRON_GOLEM, 40 }, { Monster::ROC, 15 }, { Monster::GENIE, 10 } } },
+              { Heroes::ZOM, 3, 3, 12, 12, { Spell::DEATHWAVE, Spell::LIGHTNINGBOLT, Spell::ARMAGEDDON, Spell::MASSSLOW, Spell::MASSCURSE, Spell::PARALYZE },
+                { { Monster::SKELETON, 120 }, { Monster::ROYAL_MUMMY, 30 }, { Monster::POWER_LICH, 15 }, { Monster::BONE_DRAGON, 6 } } } },
+            { "Hero vs wandering monsters", false,
+              { Heroes::JOJOSH, 6, 2, 1, 1, {}, { { Monster::ORC_CHIEF, 40 }, { Monster::OGRE_LORD, 20 }, { Monster::WAR_TROLL, 15 }, { Monster::WOLF, 40 } } },
+              { Heroes::UNKNOWN, 0, 0, 0, 0, {}, { { Monster::EARTH_ELEMENT, 40 }, { Monster::FIRE_ELEMENT, 40 }, { Monster::MEDUSA, 30 }, { Monster::HYDRA, 8 } } } },
+            { "Castle siege by melee units", true,
+              { Heroes::CRAGHACK, 6, 3, 2, 2, {}, { { Monster::OGRE_LORD, 40 }, { Monster::WAR_TROLL, 30 }, { Monster::CYCLOPS, 20 }, { Monster::WOLF, 60 } } },
+              { Heroes::UNKNOWN, 0, 0, 0, 0, {}, { { Monster::RANGER, 50 }, { Monster::VETERAN_PIKEMAN, 60 }, { Monster::CRUSADER, 15 } } } },
+            { "Castle siege by spellcasters", true,
+              { Heroes::VESPER, 2, 2, 10, 10, { Spell::EARTHQUAKE, Spell::FIREBLAST, Spell::CHAINLIGHTNING, Spell::MASSHASTE, Spell::BERSERKER },
+                { { Monster::GREEN_DRAGON, 6 }, { Monster::HYDRA, 12 }, { Monster::MINOTAUR_KING, 25 }, { Monster::GRIFFIN, 30 } } },
+              { Heroes::UNKNOWN, 0, 0, 0, 0, {}, { { Monster::GRAND_ELF, 50 }, { Monster::GREATER_DRUID, 20 }, { Monster::BATTLE_DWARF, 50 } } } } };
+
+        return battles;
+    }
+
+    void setupBenchmarkArmy( Army & army, const std::vector<BenchmarkTroop> & troops )
+    {
+        army.Clean();
+
+        for ( const BenchmarkTroop & troop : troops ) {
+            army.JoinTroop( Monster( troop.monster ), troop.count, true );
+        }
+    }
+
+    void setupBenchmarkSpells( Heroes & hero, const std::vector<int> & spells )
+    {
+        if ( spells.empty() ) {
+            return;
+        }
+
+        hero.SpellBookActivate();
+
+        for ( const int spell : spells ) {
+            hero.AppendSpellToBook( Spell( spell ), true );
+        }
+    }
+
+    // Returns the first castle of the map that can be besieged without its heroes.
+    Castle * getBenchmarkCastle()
+    {
+        const int32_t size = world.w() * world.h();
+
+        for ( int32_t index = 0; index < size; ++index ) {
+            Castle * castle = world.getCastleEntrance( Maps::GetPoint( index ) );
+            if ( castle == nullptr || !castle->isCastle() ) {
+                continue;
+            }
+
+            const CastleHeroes heroes = world.GetHeroes( *castle );
+            if ( heroes.Guest() == nullptr && heroes.Guard() == nullptr ) {
+                return castle;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void hashArmy( size_t & hash, const Army & army )
+    {
+        for ( size_t i = 0; i < army.Size(); ++i ) {
+            const Troop * troop = army.GetTroop( i );
+            if ( troop->isValid() ) {
+                fheroes2::hashCombine( hash, troop->GetID() );
+                fheroes2::hashCombine( hash, troop->GetCount() );
+            }
+            else {
+                fheroes2::hashCombine( hash, 0 );
+            }
+        }
+    }
 }
 
 void Battle::ControlInfo::Redraw( void ) const
@@ -68,6 +181,7 @@ void Battle::ControlInfo::Redraw( void ) const
 Battle::Only::Only()
     : hero1( nullptr )
     , hero2( nullptr )
+    , castle( nullptr )
     , player1( Color::BLUE )
     , player2( Color::NONE )
     , army1( nullptr )
@@ -580,7 +694,7 @@ void Battle::Only::RedrawBaseInfo( const fheroes2::Point & top ) const
     fheroes2::RedrawPrimarySkillInfo( top, primskill_bar1.get(), primskill_bar2.get() );
 }
 
-void Battle::Only::StartBattle( void )
+Battle::Result Battle::Only::StartBattle( void )
 {
     Settings & conf = Settings::Get();
 
@@ -607,6 +721,122 @@ void Battle::Only::StartBattle( void )
         Players::SetPlayerControl( player1.GetColor(), player1.GetControl() );
         Players::SetPlayerControl( player2.GetColor(), player2.GetControl() );
 
-        Battle::Loader( hero1->GetArmy(), ( hero2 ? hero2->GetArmy() : monsters ), hero1->GetIndex() + 1 );
+        if ( castle ) {
+            return Battle::Loader( hero1->GetArmy(), castle->GetArmy(), castle->GetIndex() );
+        }
+
+        return Battle::Loader( hero1->GetArmy(), ( hero2 ? hero2->GetArmy() : monsters ), hero1->GetIndex() + 1 );
+    }
+
+    return Result();
+}
+
+size_t Battle::Only::GetBenchmarkBattleCount()
+{
+    return getBenchmarkBattles().size();
+}
+
+const char * Battle::Only::GetBenchmarkBattleName( const size_t id )
+{
+    return getBenchmarkBattles()[id].name;
+}
+
+bool Battle::Only::isBenchmarkSiege( const size_t id )
+{
+    return getBenchmarkBattles()[id].isSiege;
+}
+
+Heroes * Battle::Only::SetupBenchmarkHero( const int heroId, const int attack, const int defense, const int power, const int knowledge )
+{
+    Heroes * hero = world.GetHeroes( heroId );
+    if ( hero == nullptr ) {
+        return nullptr;
+    }
+
+    // Heroes placed on a loaded map have to be released before they can be recruited for the battle
+    if ( !hero->isFreeman() ) {
+        hero->SetFreeman( 0 );
     }
+
+    hero->attack = attack;
+    hero->defense = defense;
+    hero->power = power;
+    hero->knowledge = knowledge;
+
+    return hero;
+}
+
+bool Battle::Only::SetupBenchmarkBattle( const size_t id )
+{
+    const BenchmarkBattle & battle = getBenchmarkBattles()[id];
+
+    const BenchmarkSide & attacker = battle.attacker;
+    hero1 = SetupBenchmarkHero( attacker.heroId, attacker.attack, attacker.defense, attacker.power, attacker.knowledge );
+    if ( hero1 == nullptr ) {
+        return false;
+    }
+
+    setupBenchmarkArmy( hero1->GetArmy(), attacker.troops );
+    setupBenchmarkSpells( *hero1, attacker.spells );
+    army1 = &hero1->GetArmy();
+
+    player1.SetColor( Color::BLUE );
+    player1.SetRace( hero1->GetRace() );
+    player1.SetControl( CONTROL_AI );
+
+    const BenchmarkSide & defender = battle.defender;
+
+    if ( battle.isSiege ) {
+        castle = getBenchmarkCastle();
+        if ( castle == nullptr ) {
+            return false;
+        }
+
+        // A neutral castle is always controlled by AI
+        castle->ChangeColor( Color::NONE );
+        setupBenchmarkArmy( castle->GetArmy(), defender.troops );
+        army2 = &castle->GetArmy();
+        return true;
+    }
+
+    if ( defender.heroId == Heroes::UNKNOWN ) {
+        setupBenchmarkArmy( monsters, defender.troops );
+        army2 = &monsters;
+        return true;
+    }
+
+    hero2 = SetupBenchmarkHero( defender.heroId, defender.attack, defender.defense, defender.power, defender.knowledge );
+    if ( hero2 == nullptr ) {
+        return false;
+    }
+
+    setupBenchmarkArmy( hero2->GetArmy(), defender.troops );
+    setupBenchmarkSpells( *hero2, defender.spells );
+    army2 = &hero2->GetArmy();
+
+    player2.SetColor( Color::RED );
+    player2.SetRace( hero2->GetRace() );
+    player2.SetControl( CONTROL_AI );
+
+    return true;
+}
+
+size_t Battle::Only::GetOutcomeHash( const Result & result ) const
+{
+    size_t hash = 0;
+
+    fheroes2::hashCombine( hash, result.army1 );
+    fheroes2::hashCombine( hash, result.army2 );
+    fheroes2::hashCombine( hash, result.exp1 );
+    fheroes2::hashCombine( hash, result.exp2 );
+    fheroes2::hashCombine( hash, result.killed );
+
+    if ( army1 ) {
+        hashArmy( hash, *army1 );
+    }
+    if ( army2 ) {
+        hashArmy( hash, *army2 );
+    }
+
+    return hash;
 }
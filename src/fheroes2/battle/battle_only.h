@@ -25,6 +25,7 @@
 
 #include "army.h"
 #include "army_bar.h"
+#include "battle.h"
 #include "heroes_indicator.h"
 #include "players.h"
 #include "skill_bar.h"
@@ -32,6 +33,7 @@
 #include <memory>
 
 class ArtifactsBar;
+class Castle;
 
 namespace Battle
 {
@@ -58,13 +60,29 @@ namespace Battle
 
         bool ChangeSettings( void );
         void RedrawBaseInfo( const fheroes2::Point & ) const;
-        void StartBattle( void );
+        Result StartBattle( void );
         void UpdateHero1( const fheroes2::Point & );
         void UpdateHero2( const fheroes2::Point & );
 
+        // The benchmark catalog is a fixed list of battles between AI players which covers the most demanding parts of the battle engine.
+        static size_t GetBenchmarkBattleCount();
+        static const char * GetBenchmarkBattleName( const size_t id );
+
+        // Castle sieges are played in the first castle of the currently loaded map, all other battles need an empty map.
+        static bool isBenchmarkSiege( const size_t id );
+
+        // Sets up the given battle of the benchmark catalog without any dialog. Returns false if the battle can't be played on the current map.
+        bool SetupBenchmarkBattle( const size_t id );
+
+        // Returns a hash of the given result and of both armies, to be called after the battle.
+        size_t GetOutcomeHash( const Result & result ) const;
+
     private:
+        static Heroes * SetupBenchmarkHero( const int heroId, const int attack, const int defense, const int power, const int knowledge );
+
         Heroes * hero1;
         Heroes * hero2;
+        Castle * castle;
 
         Player player1;
         Player player2;
@@ -23,6 +23,7 @@
 #include "battle_bridge.h"
 #include "battle_troop.h"
 #include "castle.h"
+#include "game_benchmark.h"
 #include "logging.h"
 #include <algorithm>
 
@@ -42,18 +43,43 @@ namespace Battle
         _cache.resize( ARENASIZE );
     }
 
+    bool ArenaPathfinder::CalculationKey::operator==( const CalculationKey & other ) const
+    {
+        return headIndex == other.headIndex && tailIndex == other.tailIndex && speed == other.speed && isFlying == other.isFlying && isReflect == other.isReflect
+               && isPassableBridge == other.isPassableBridge && obstacleFreeMask == other.obstacleFreeMask && freeMask == other.freeMask;
+    }
+
     void ArenaPathfinder::reset()
     {
         _start.Set( -1, false, false );
         for ( size_t i = 0; i < _cache.size(); ++i ) {
             _cache[i].resetNode();
         }
+        _passableMask.reset();
+        _passableCellsByCost.clear();
+        _isCalculated = false;
     }
 
     bool ArenaPathfinder::hexIsPassable( int targetCell ) const
     {
         const size_t index = static_cast<size_t>( targetCell );
-        return index < _cache.size() && nodeIsPassable( _cache[index] );
+        return index < _passableMask.size() && _passableMask[index];
+    }
+
+    void ArenaPathfinder::updatePassableMask()
+    {
+        _passableMask.reset();
+        _passableCellsByCost.clear();
+
+        for ( size_t index = 0; index < _cache.size(); ++index ) {
+            if ( nodeIsPassable( _cache[index] ) ) {
+                _passableMask.set( index );
+                _passableCellsByCost.push_back( static_cast<int32_t>( index ) );
+            }
+        }
+
+        std::stable_sort( _passableCellsByCost.begin(), _passableCellsByCost.end(),
+                          [this]( const int32_t first, const int32_t second ) { return _cache[first]._cost < _cache[second]._cost; } );
     }
 
     bool ArenaPathfinder::nodeIsPassable( const ArenaNode & node ) const
@@ -66,12 +92,15 @@ namespace Battle
         Indexes result;
         result.reserve( moveRange * 2u );
 
-        for ( size_t index = 0; index < _cache.size(); ++index ) {
-            const ArenaNode & node = _cache[index];
-            if ( nodeIsPassable( node ) && node._cost <= moveRange ) {
-                result.push_back( static_cast<int>( index ) );
+        for ( const int32_t index : _passableCellsByCost ) {
+            if ( _cache[index]._cost > moveRange ) {
+                break;
             }
+            result.push_back( index );
         }
+
+        // Keep the order of cells on the board
+        std::sort( result.begin(), result.end() );
         return result;
     }
 
@@ -126,24 +155,47 @@ namespace Battle
 
     void ArenaPathfinder::calculate( const Unit & unit )
     {
-        reset();
+        const Game::Benchmark::PhaseTimer timer( Game::Benchmark::Phase::BATTLE_PATHFINDER );
 
         const bool unitIsWide = unit.isWide();
 
-        _start = unit.GetPosition();
-        const Cell * unitHead = _start.GetHead();
-        const Cell * unitTail = _start.GetTail();
+        const Position & position = unit.GetPosition();
+        const Cell * unitHead = position.GetHead();
+        const Cell * unitTail = position.GetTail();
         if ( !unitHead || ( unitIsWide && !unitTail ) ) {
+            reset();
             DEBUG_LOG( DBG_BATTLE, DBG_WARN, "Pathfinder: Invalid unit is passed in! " << unit.GetName() );
             return;
         }
 
+        const Board & board = *Arena::GetBoard();
         const Bridge * bridge = Arena::GetBridge();
         const Castle * castle = Arena::GetCastle();
 
-        const bool isPassableBridge = bridge == nullptr || bridge->isPassable( unit );
+        CalculationKey key;
+        key.headIndex = unitHead->GetIndex();
+        key.tailIndex = unitIsWide ? unitTail->GetIndex() : -1;
+        key.speed = unit.GetSpeed();
+        key.isFlying = unit.isFlying();
+        key.isReflect = unit.isReflect();
+        key.isPassableBridge = bridge == nullptr || bridge->isPassable( unit );
+        // Cells without obstacles (units are allowed) and cells free of obstacles and units
+        key.obstacleFreeMask = board.GetPassableMask( false );
+        key.freeMask = board.GetPassableMask( true );
+
+        if ( _isCalculated && _key == key ) {
+            return;
+        }
+
+        reset();
+
+        _key = key;
+        _isCalculated = true;
+        _start = position;
+
+        const bool isPassableBridge = key.isPassableBridge;
         const bool isMoatBuilt = castle && castle->isBuild( BUILD_MOAT );
-        const uint32_t moatPenalty = unit.GetSpeed();
+        const uint32_t moatPenalty = key.speed;
 
         // Initialize the starting cells
         const int32_t pathStart = unitHead->GetIndex();
@@ -159,16 +211,18 @@ namespace Battle
             _cache[tailIdx]._isLeftDirection = !unit.isReflect();
         }
 
-        if ( unit.isFlying() ) {
-            const Board & board = *Arena::GetBoard();
+        if ( key.isFlying ) {
+            // Find all free spaces on the battle board - flyers can move to any of them. There should be space for the tail of wide units.
+            CellMask placeableMask = board.GetPlaceableMask( unit );
+            if ( !isPassableBridge ) {
+                placeableMask &= ~Board::GetBridgeMask( unit );
+            }
 
-            // Find all free spaces on the battle board - flyers can move to any of them
             for ( Board::const_iterator it = board.begin(); it != board.end(); ++it ) {
                 const int32_t idx = it->GetIndex();
                 ArenaNode & node = _cache[idx];
 
-                // isPassable3 checks if there's space for unit tail (for wide units)
-                if ( it->isPassable3( unit, false ) && ( isPassableBridge || !Board::isBridgeIndex( it - board.begin(), unit ) ) ) {
+                if ( placeableMask[idx] ) {
                     node._isOpen = true;
                     node._from = pathStart;
                     node._cost = Battle::Board::GetDistance( pathStart, idx );
@@ -177,6 +231,8 @@ namespace Battle
                     node._isOpen = false;
                 }
             }
+            updatePassableMask();
+
             // Once board movement is determined we look for units save shortest flight path to them
             for ( Board::const_iterator it = board.begin(); it != board.end(); ++it ) {
                 const Unit * boardUnit = it->GetUnit();
@@ -184,8 +240,7 @@ namespace Battle
                     const int32_t unitIdx = it->GetIndex();
                     ArenaNode & unitNode = _cache[unitIdx];
 
-                    const Indexes & around = Battle::Board::GetAroundIndexes( unitIdx );
-                    for ( const int32_t cell : around ) {
+                    for ( const int32_t cell : Battle::Board::GetAroundIndexesView( unitIdx ) ) {
                         const uint32_t flyingDist = Battle::Board::GetDistance( pathStart, cell );
                         if ( hexIsPassable( cell ) && ( flyingDist < unitNode._cost ) ) {
                             unitNode._isOpen = false;
@@ -197,6 +252,16 @@ namespace Battle
             }
         }
         else {
+            // Cells without obstacles (units are allowed) where the head of the unit may be placed
+            CellMask headMask = key.obstacleFreeMask;
+            if ( !isPassableBridge ) {
+                headMask &= ~Board::GetBridgeMask( unit );
+            }
+
+            // Cells free of obstacles and units
+            const CellMask & freeMask = key.freeMask;
+            const CellMask moatMask = isMoatBuilt ? Board::GetMoatMask( unit ) : CellMask();
+
             // Walkers - explore moves sequentially from both head and tail cells
             std::vector<int32_t> nodesToExplore;
             nodesToExplore.push_back( pathStart );
@@ -220,11 +285,10 @@ namespace Battle
                     const bool isLeftDirection = unitIsWide && Board::IsLeftDirection( fromNode, newNode, previousNode._isLeftDirection );
 
                     const int32_t newTailIndex = isLeftDirection ? newNode + 1 : newNode - 1;
-                    const Cell * tailCell = ( unitIsWide && !_start.contains( newTailIndex ) ) ? Board::GetCell( newTailIndex ) : nullptr;
+                    const bool isTailChecked = unitIsWide && !_start.contains( newTailIndex ) && Board::isValidIndex( newTailIndex );
 
-                    // Special case: headCell is *allowed* to have another unit in it, that's why we check isPassable1( false ) instead of isPassable4
-                    if ( headCell->isPassable1( false ) && ( !tailCell || tailCell->isPassable1( true ) )
-                         && ( isPassableBridge || !Board::isBridgeIndex( newNode, unit ) ) ) {
+                    // Special case: headCell is *allowed* to have another unit in it, that's why the head is checked against the mask of obstacles only
+                    if ( headMask[newNode] && ( !isTailChecked || freeMask[newTailIndex] ) ) {
                         const uint32_t cost = previousNode._cost;
                         ArenaNode & node = _cache[newNode];
 
@@ -234,8 +298,7 @@ namespace Battle
                             additionalCost = 0;
                         }
                         // Moat penalty consumes all remaining movement. Be careful when dealing with unsigned values.
-                        else if ( isMoatBuilt && ( Board::isMoatIndex( newNode, unit ) || Board::isMoatIndex( newTailIndex, unit ) )
-                                  && moatPenalty > previousNode._cost ) {
+                        else if ( ( moatMask[newNode] || ( Board::isValidIndex( newTailIndex ) && moatMask[newTailIndex] ) ) && moatPenalty > previousNode._cost ) {
                             additionalCost = moatPenalty - cost;
                         }
 
@@ -257,5 +320,7 @@ namespace Battle
                 }
             }
         }
+
+        updatePassableMask();
     }
 }
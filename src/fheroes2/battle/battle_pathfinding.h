@@ -20,6 +20,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
 #include "battle_board.h"
 #include "pathfinding.h"
 
@@ -58,15 +61,46 @@ namespace Battle
     public:
         ArenaPathfinder();
         void reset() override;
+
+        // The results of the previous calculation are reused if neither the unit nor the occupancy of the board has changed since then
         void calculate( const Unit & unit );
         Indexes buildPath( int targetCell ) const;
         Indexes findTwoMovesOverlap( int targetCell, uint32_t movementRange ) const;
         bool hexIsPassable( int targetCell ) const;
         Indexes getAllAvailableMoves( uint32_t moveRange ) const;
 
+        // Mask of cells for which hexIsPassable() returns true
+        const CellMask & getPassableMask() const
+        {
+            return _passableMask;
+        }
+
     private:
+        // Everything the results of calculate() depend on
+        struct CalculationKey
+        {
+            int32_t headIndex = -1;
+            int32_t tailIndex = -1;
+            uint32_t speed = 0;
+            bool isFlying = false;
+            bool isReflect = false;
+            bool isPassableBridge = false;
+            CellMask obstacleFreeMask;
+            CellMask freeMask;
+
+            bool operator==( const CalculationKey & other ) const;
+        };
+
         bool nodeIsPassable( const ArenaNode & node ) const;
+        void updatePassableMask();
 
         Position _start;
+        CellMask _passableMask;
+
+        // Passable cells sorted by the cost of movement to them
+        std::vector<int32_t> _passableCellsByCost;
+
+        CalculationKey _key;
+        bool _isCalculated = false;
     };
 }
@@ -0,0 +1,374 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2021                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <utility>
+
+#include "army.h"
+#include "battle_arena.h"
+#include "battle_army.h"
+#include "battle_replay.h"
+#include "battle_troop.h"
+#include "castle.h"
+#include "game.h"
+#include "heroes.h"
+#include "logging.h"
+#include "maps.h"
+#include "monster.h"
+#include "rand.h"
+#include "save_format_version.h"
+#include "settings.h"
+#include "system.h"
+#include "timing.h"
+#include "world.h"
+
+namespace
+{
+    const uint16_t replayFileId = 0xFB03;
+
+    std::string replayDirectory;
+    uint32_t replayCounter = 0;
+
+    // An army in a replay is either the army of a hero or a castle from the saved world or an army of its own (monsters on the map)
+    enum class ArmySource : uint8_t
+    {
+        HERO,
+        CASTLE,
+        OTHER
+    };
+
+    void writeArmy( StreamBase & msg, const Army & army )
+    {
+        const Heroes * hero = dynamic_cast<const Heroes *>( army.GetCommander() );
+        if ( hero != nullptr ) {
+            msg << static_cast<uint8_t>( ArmySource::HERO ) << static_cast<int32_t>( hero->GetID() );
+            return;
+        }
+
+        const Castle * castle = army.inCastle();
+        if ( castle != nullptr && &castle->GetArmy() == &army ) {
+            msg << static_cast<uint8_t>( ArmySource::CASTLE ) << castle->GetIndex();
+            return;
+        }
+
+        msg << static_cast<uint8_t>( ArmySource::OTHER ) << army;
+    }
+
+    Army * readArmy( StreamBase & msg, std::unique_ptr<Army> & otherArmy )
+    {
+        uint8_t source = 0;
+        msg >> source;
+
+        switch ( static_cast<ArmySource>( source ) ) {
+        case ArmySource::HERO: {
+            int32_t heroId = 0;
+            msg >> heroId;
+
+            Heroes * hero = world.GetHeroes( heroId );
+            return hero != nullptr ? &hero->GetArmy() : nullptr;
+        }
+        case ArmySource::CASTLE: {
+            int32_t castleIndex = 0;
+            msg >> castleIndex;
+
+            Castle * castle = Maps::isValidAbsIndex( castleIndex ) ? world.getCastleEntrance( Maps::GetPoint( castleIndex ) ) : nullptr;
+            return castle != nullptr ? &castle->GetArmy() : nullptr;
+        }
+        case ArmySource::OTHER:
+            otherArmy.reset( new Army );
+            msg >> *otherArmy;
+            return otherArmy.get();
+        default:
+            break;
+        }
+
+        return nullptr;
+    }
+
+    struct ReplayOutcome
+    {
+        Battle::Result result;
+        // Monster type and count of every unit of both sides, including the dead and summoned ones
+        std::vector<std::pair<uint32_t, uint32_t>> units;
+
+        explicit ReplayOutcome( Battle::Arena & arena )
+            : result( arena.GetResult() )
+        {
+            for ( const Battle::Force * force : { &arena.GetForce1(), &arena.GetForce2() } ) {
+                for ( const Battle::Unit * unit : *force ) {
+                    units.emplace_back( static_cast<uint32_t>( unit->GetID() ), unit->GetCount() );
+                }
+            }
+        }
+
+        ReplayOutcome() = default;
+
+        bool operator==( const ReplayOutcome & other ) const
+        {
+            return result.army1 == other.result.army1 && result.army2 == other.result.army2 && result.exp1 == other.result.exp1
+                   && result.exp2 == other.result.exp2 && result.killed == other.result.killed && units == other.units;
+        }
+    };
+
+    StreamBase & operator<<( StreamBase & msg, const ReplayOutcome & outcome )
+    {
+        return msg << outcome.result.army1 << outcome.result.army2 << outcome.result.exp1 << outcome.result.exp2 << outcome.result.killed << outcome.units;
+    }
+
+    StreamBase & operator>>( StreamBase & msg, ReplayOutcome & outcome )
+    {
+        return msg >> outcome.result.army1 >> outcome.result.army2 >> outcome.result.exp1 >> outcome.result.exp2 >> outcome.result.killed >> outcome.units;
+    }
+
+    std::string outcomeString( const ReplayOutcome & outcome )
+    {
+        std::ostringstream os;
+        os << "army1: " << outcome.result.army1 << ", army2: " << outcome.result.army2 << ", exp1: " << outcome.result.exp1 << ", exp2: " << outcome.result.exp2
+           << ", killed: " << outcome.result.killed << ", units:";
+        for ( const std::pair<uint32_t, uint32_t> & unit : outcome.units ) {
+            os << " " << Monster( static_cast<int>( unit.first ) ).GetName() << " " << unit.second;
+        }
+        return os.str();
+    }
+}
+
+void Battle::ReplayTurns::clear()
+{
+    _commands.clear();
+    _turnSizes.clear();
+    _turnSeeds.clear();
+    _nextCommand = 0;
+    _nextTurn = 0;
+}
+
+void Battle::ReplayTurns::add( const Actions & actions, const size_t seed )
+{
+    _commands.insert( _commands.end(), actions.begin(), actions.end() );
+    _turnSizes.push_back( static_cast<uint32_t>( actions.size() ) );
+    _turnSeeds.push_back( seed );
+}
+
+bool Battle::ReplayTurns::getNext( Actions & actions, size_t & seed )
+{
+    if ( isExhausted() ) {
+        return false;
+    }
+
+    const size_t turnSize = _turnSizes[_nextTurn];
+    if ( _nextCommand + turnSize > _commands.size() || _nextTurn >= _turnSeeds.size() ) {
+        // Broken replay: consider it to be over
+        _nextTurn = _turnSizes.size();
+        return false;
+    }
+
+    for ( size_t i = 0; i < turnSize; ++i ) {
+        actions.push_back( _commands[_nextCommand + i] );
+    }
+
+    seed = static_cast<size_t>( _turnSeeds[_nextTurn] );
+
+    _nextCommand += turnSize;
+    ++_nextTurn;
+
+    return true;
+}
+
+StreamBase & Battle::operator<<( StreamBase & msg, const ReplayTurns & turns )
+{
+    msg << turns._turnSizes << static_cast<uint32_t>( turns._turnSeeds.size() );
+
+    // Seeds are stored as two halves to keep the replays portable between 32 and 64-bit platforms
+    for ( const uint64_t seed : turns._turnSeeds ) {
+        msg << static_cast<uint32_t>( seed >> 32 ) << static_cast<uint32_t>( seed & 0xFFFFFFFF );
+    }
+
+    msg << static_cast<uint32_t>( turns._commands.size() );
+
+    for ( const Command & command : turns._commands ) {
+        msg << static_cast<int32_t>( command.GetType() ) << static_cast<uint8_t>( command.size() );
+        for ( const int param : command ) {
+            msg << static_cast<int32_t>( param );
+        }
+    }
+
+    return msg;
+}
+
+StreamBase & Battle::operator>>( StreamBase & msg, ReplayTurns & turns )
+{
+    turns.clear();
+
+    uint32_t seedsCount = 0;
+    msg >> turns._turnSizes >> seedsCount;
+
+    turns._turnSeeds.reserve( seedsCount );
+
+    for ( uint32_t i = 0; i < seedsCount && !msg.fail(); ++i ) {
+        uint32_t seedHigh = 0;
+        uint32_t seedLow = 0;
+        msg >> seedHigh >> seedLow;
+
+        turns._turnSeeds.push_back( ( static_cast<uint64_t>( seedHigh ) << 32 ) | seedLow );
+    }
+
+    uint32_t commandsCount = 0;
+    msg >> commandsCount;
+
+    turns._commands.reserve( commandsCount );
+
+    for ( uint32_t i = 0; i < commandsCount && !msg.fail(); ++i ) {
+        int32_t type = 0;
+        uint8_t paramsCount = 0;
+        msg >> type >> paramsCount;
+
+        if ( paramsCount > Command::MAX_PARAMS_COUNT ) {
+            // Broken replay: the rest of the stream can't be read anyway
+            turns.clear();
+            break;
+        }
+
+        Command command( static_cast<CommandType>( type ) );
+        for ( uint8_t j = 0; j < paramsCount; ++j ) {
+            int32_t param = 0;
+            msg >> param;
+            command << param;
+        }
+
+        turns._commands.push_back( command );
+    }
+
+    return msg;
+}
+
+Battle::ReplayRecorder::ReplayRecorder( const Army & army1, const Army & army2, const int32_t mapsIndex, const size_t seed )
+{
+    const uint64_t fullSeed = seed;
+
+    _stream.setbigendian( true );
+    _stream << replayFileId << Game::GetLoadVersion() << World::Get() << Settings::Get() << mapsIndex << static_cast<uint32_t>( fullSeed >> 32 )
+            << static_cast<uint32_t>( fullSeed & 0xFFFFFFFF );
+
+    writeArmy( _stream, army1 );
+    writeArmy( _stream, army2 );
+}
+
+bool Battle::ReplayRecorder::save( Arena & arena )
+{
+    _stream << _turns << ReplayOutcome( arena ) << replayFileId;
+
+    ++replayCounter;
+
+    std::ostringstream os;
+    os << "battle_day" << std::setw( 4 ) << std::setfill( '0' ) << world.CountDay() << "_" << std::setw( 4 ) << std::setfill( '0' ) << replayCounter << ".rpl";
+
+    const std::string fileName = System::ConcatePath( replayDirectory, os.str() );
+    if ( _stream.fail() || !_stream.write( fileName ) ) {
+        ERROR_LOG( "Failed to save the battle replay to " << fileName );
+        return false;
+    }
+
+    DEBUG_LOG( DBG_BATTLE, DBG_INFO, "battle replay is saved to " << fileName );
+    return true;
+}
+
+void Battle::SetReplayDirectory( const std::string & directory )
+{
+    replayDirectory = directory;
+}
+
+bool Battle::isReplayRecordingEnabled()
+{
+    return !replayDirectory.empty();
+}
+
+int Battle::PlayReplay( const std::string & fileName )
+{
+    ZStreamFile fz;
+    fz.setbigendian( true );
+
+    if ( !fz.read( fileName ) ) {
+        ERROR_LOG( "Failed to read the battle replay " << fileName );
+        return EXIT_FAILURE;
+    }
+
+    uint16_t fileId = 0;
+    uint16_t version = 0;
+    fz >> fileId >> version;
+
+    if ( fileId != replayFileId || version > CURRENT_FORMAT_VERSION || version < LAST_SUPPORTED_FORMAT_VERSION ) {
+        ERROR_LOG( "Unsupported battle replay " << fileName );
+        return EXIT_FAILURE;
+    }
+
+    Game::SetLoadVersion( version );
+
+    int32_t mapsIndex = -1;
+    uint32_t seedHigh = 0;
+    uint32_t seedLow = 0;
+    fz >> World::Get() >> Settings::Get() >> mapsIndex >> seedHigh >> seedLow;
+
+    std::unique_ptr<Army> otherArmy1;
+    std::unique_ptr<Army> otherArmy2;
+    Army * army1 = readArmy( fz, otherArmy1 );
+    Army * army2 = readArmy( fz, otherArmy2 );
+
+    ReplayTurns turns;
+    ReplayOutcome expectedOutcome;
+    uint16_t endMarker = 0;
+    fz >> turns >> expectedOutcome >> endMarker;
+
+    Game::SetLoadVersion( CURRENT_FORMAT_VERSION );
+
+    if ( fz.fail() || endMarker != replayFileId || army1 == nullptr || army2 == nullptr ) {
+        ERROR_LOG( "Invalid battle replay " << fileName );
+        return EXIT_FAILURE;
+    }
+
+    // The seed is stored as two halves to keep the replays portable between 32 and 64-bit platforms
+    const size_t seed = static_cast<size_t>( ( static_cast<uint64_t>( seedHigh ) << 32 ) | seedLow );
+
+    const fheroes2::Time timer;
+
+    Rand::DeterministicRandomGenerator randomGenerator( seed );
+    Arena arena( *army1, *army2, mapsIndex, false, randomGenerator );
+    arena.SetReplay( &turns, true );
+
+    while ( arena.BattleValid() && !turns.isExhausted() ) {
+        arena.Turns();
+    }
+
+    const ReplayOutcome outcome( arena );
+    const double playTime = timer.get();
+
+    COUT( "Battle replay: " << fileName << ", turns: " << arena.GetCurrentTurn() << ", time: " << std::fixed << std::setprecision( 3 ) << playTime << " s" );
+
+    if ( !( outcome == expectedOutcome ) ) {
+        COUT( "The battle outcome doesn't match the recorded one" );
+        COUT( "Expected: " << outcomeString( expectedOutcome ) );
+        COUT( "Actual: " << outcomeString( outcome ) );
+        return EXIT_FAILURE;
+    }
+
+    COUT( "The battle outcome matches the recorded one" );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2021                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "battle_command.h"
+#include "serialize.h"
+#include "zzlib.h"
+
+class Army;
+
+namespace Battle
+{
+    class Arena;
+
+    // Decisions of players and AI in the order they have been made during a battle together with the state of the battle
+    // random generator after each decision. Everything else in a battle (morale, towers, catapult, damage rolls) is derived
+    // from the generator. The AI consumes the generator while planning and it is not run during playback, so the state is
+    // restored from the replay instead.
+    class ReplayTurns
+    {
+    public:
+        void clear();
+
+        void add( const Actions & actions, const size_t seed );
+
+        // Returns false if all recorded decisions have been used already
+        bool getNext( Actions & actions, size_t & seed );
+
+        bool isExhausted() const
+        {
+            return _nextTurn >= _turnSizes.size();
+        }
+
+        friend StreamBase & operator<<( StreamBase &, const ReplayTurns & );
+        friend StreamBase & operator>>( StreamBase &, ReplayTurns & );
+
+    private:
+        std::vector<Command> _commands;
+        std::vector<uint32_t> _turnSizes;
+        std::vector<uint64_t> _turnSeeds;
+        size_t _nextCommand = 0;
+        size_t _nextTurn = 0;
+    };
+
+    StreamBase & operator<<( StreamBase &, const ReplayTurns & );
+    StreamBase & operator>>( StreamBase &, ReplayTurns & );
+
+    // Records a battle into a file to replay it later without the interface. The arena reads the map, castles and heroes
+    // so the state of the world is saved when the recorder is created, that is right before the battle starts.
+    class ReplayRecorder
+    {
+    public:
+        ReplayRecorder( const Army & army1, const Army & army2, const int32_t mapsIndex, const size_t seed );
+
+        ReplayTurns & getTurns()
+        {
+            return _turns;
+        }
+
+        // Saves the recorded battle after its end into the replay directory
+        bool save( Arena & arena );
+
+    private:
+        ZStreamFile _stream;
+        ReplayTurns _turns;
+    };
+
+    // Battles are recorded into the given directory if it isn't empty
+    void SetReplayDirectory( const std::string & directory );
+    bool isReplayRecordingEnabled();
+
+    // Plays the battle from the given replay file at full speed and checks that its outcome is the same as the recorded one.
+    // Returns EXIT_SUCCESS if the outcome matches.
+    int PlayReplay( const std::string & fileName );
+}
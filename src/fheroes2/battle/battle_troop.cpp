@@ -395,13 +395,19 @@ bool Battle::Unit::canReach( const Unit & unit ) const
 bool Battle::Unit::isHandFighting( void ) const
 {
     if ( GetCount() && !Modes( CAP_TOWER ) ) {
-        const Indexes around = Board::GetAroundIndexes( *this );
+        auto isEnemyAround = [this]( const int32_t center ) {
+            for ( const int32_t index : Board::GetAroundIndexesView( center ) ) {
+                const Unit * enemy = Board::GetCell( index )->GetUnit();
+                if ( enemy && enemy->GetColor() != GetColor() )
+                    return true;
+            }
 
-        for ( Indexes::const_iterator it = around.begin(); it != around.end(); ++it ) {
-            const Unit * enemy = Board::GetCell( *it )->GetUnit();
-            if ( enemy && enemy->GetColor() != GetColor() )
-                return true;
-        }
+            return false;
+        };
+
+        // The cells of the unit itself are not occupied by enemies so there is no need to exclude them
+        if ( isEnemyAround( GetHeadIndex() ) || ( isWide() && isEnemyAround( GetTailIndex() ) ) )
+            return true;
     }
 
     return false;
@@ -1311,6 +1311,9 @@ bool Castle::BuyBuilding( u32 build )
     // add build
     building |= build;
 
+    // Some buildings affect morale, luck or defense of the castle garrison
+    Army::InvalidateStrengthCache();
+
     switch ( build ) {
     case BUILD_CASTLE:
         building &= ~BUILD_TENT;
@@ -20,17 +20,20 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <string>
 
 #include "agg.h"
 #include "audio.h"
+#include "battle_replay.h"
 #include "bin_info.h"
 #include "core.h"
 #include "cursor.h"
 #include "embedded_image.h"
 #include "game.h"
+#include "game_benchmark.h"
 #include "game_logo.h"
 #include "game_video.h"
 #include "image_palette.h"
@@ -39,9 +42,7 @@
 #include "screen.h"
 #include "settings.h"
 #include "system.h"
-#ifdef WITH_DEBUG
 #include "tools.h"
-#endif
 #include "ui_tool.h"
 #include "zzlib.h"
 
@@ -58,6 +59,13 @@ namespace
 #ifdef WITH_DEBUG
         COUT( "  -d <level>\tprint debug messages, see src/engine/logging.h for possible values of <level> argument" );
 #endif
+        COUT( "  -b <file>\trun a headless AI game from the given map or saved game file and print timings" );
+        COUT( "  -n <days>\tnumber of days to play in a headless AI game (default: 30)" );
+        COUT( "  -s <seed>\trandom seed of a headless AI game or battle benchmark (default: 0)" );
+        COUT( "  -t <rounds>\trun the headless battle benchmark the given number of rounds, castle sieges are played on the map given by -b" );
+        COUT( "  -r <dir>\trecord replays of all battles into the given directory" );
+        COUT( "  -p <file>\tplay the given battle replay headlessly and check its outcome" );
+        COUT( "  -c <file>\trun the world pathfinder checks on the given map or saved game file" );
         COUT( "  -h\t\tprint this help message and exit" );
 
         return EXIT_SUCCESS;
@@ -165,16 +173,51 @@ int main( int argc, char ** argv )
         InitDataDir();
         ReadConfigs();
 
+        std::string benchmarkFile;
+        uint32_t benchmarkDays = 30;
+        uint32_t benchmarkSeed = 0;
+        uint32_t battleBenchmarkRounds = 0;
+        std::string replayFile;
+        std::string pathfinderCheckFile;
+
         // getopt
         {
             int opt;
-            while ( ( opt = System::GetCommandOptions( argc, argv, "hd:" ) ) != -1 )
+            while ( ( opt = System::GetCommandOptions( argc, argv, "hd:b:n:s:t:r:p:c:" ) ) != -1 )
                 switch ( opt ) {
 #ifdef WITH_DEBUG
                 case 'd':
                     conf.SetDebug( System::GetOptionsArgument() ? GetInt( System::GetOptionsArgument() ) : 0 );
                     break;
 #endif
+                case 'b':
+                    benchmarkFile = System::GetOptionsArgument() ? System::GetOptionsArgument() : "";
+                    break;
+
+                case 'n':
+                    benchmarkDays = System::GetOptionsArgument() ? static_cast<uint32_t>( std::max( GetInt( System::GetOptionsArgument() ), 0 ) ) : 0;
+                    break;
+
+                case 's':
+                    benchmarkSeed = System::GetOptionsArgument() ? static_cast<uint32_t>( GetInt( System::GetOptionsArgument() ) ) : 0;
+                    break;
+
+                case 't':
+                    battleBenchmarkRounds = System::GetOptionsArgument() ? static_cast<uint32_t>( std::max( GetInt( System::GetOptionsArgument() ), 0 ) ) : 0;
+                    break;
+
+                case 'r':
+                    Battle::SetReplayDirectory( System::GetOptionsArgument() ? System::GetOptionsArgument() : "" );
+                    break;
+
+                case 'p':
+                    replayFile = System::GetOptionsArgument() ? System::GetOptionsArgument() : "";
+                    break;
+
+                case 'c':
+                    pathfinderCheckFile = System::GetOptionsArgument() ? System::GetOptionsArgument() : "";
+                    break;
+
                 case '?':
                 case 'h':
                     return PrintHelp( argv[0] );
@@ -184,6 +227,34 @@ int main( int argc, char ** argv )
                 }
         }
 
+        if ( !benchmarkFile.empty() || !replayFile.empty() || !pathfinderCheckFile.empty() || battleBenchmarkRounds > 0 ) {
+            // Neither audio nor video is initialized: only the game logic runs.
+            const std::set<fheroes2::SystemInitializationComponent> noComponents;
+            const fheroes2::CoreInitializer coreInitializer( noComponents );
+
+            const AGG::AGGInitializer aggInitializer;
+
+            fheroes2::setGamePalette( AGG::ReadChunk( "KB.PAL" ) );
+
+            Bin_Info::InitBinInfo();
+
+            Game::Init();
+
+            if ( !replayFile.empty() ) {
+                return Battle::PlayReplay( replayFile );
+            }
+
+            if ( !pathfinderCheckFile.empty() ) {
+                return Game::Benchmark::RunPathfinderChecks( pathfinderCheckFile );
+            }
+
+            if ( battleBenchmarkRounds > 0 ) {
+                return Game::Benchmark::RunBattles( benchmarkFile, battleBenchmarkRounds, benchmarkSeed );
+            }
+
+            return Game::Benchmark::RunAIGame( benchmarkFile, benchmarkDays, benchmarkSeed );
+        }
+
         std::set<fheroes2::SystemInitializationComponent> coreComponents{ fheroes2::SystemInitializationComponent::Audio,
                                                                           fheroes2::SystemInitializationComponent::Video };
 
@@ -0,0 +1,542 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2021                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "ai.h"
+#include "battle_only.h"
+#include "game.h"
+#include "game_benchmark.h"
+#include "game_io.h"
+#include "kingdom.h"
+#include "logging.h"
+#include "maps.h"
+#include "maps_fileinfo.h"
+#include "players.h"
+#include "rand.h"
+#include "settings.h"
+#include "timing.h"
+#include "tools.h"
+#include "world.h"
+#include "world_pathfinding.h"
+
+namespace
+{
+    struct PhaseStatistics
+    {
+        double time = 0;
+        uint32_t count = 0;
+    };
+
+    struct BattleStatistics
+    {
+        double time = 0;
+        uint32_t count = 0;
+        size_t outcomeHash = 0;
+    };
+
+    bool isBenchmarkRunning = false;
+
+    // Parts of the AI may run on worker threads, only the thread running the benchmark is measured.
+    std::thread::id benchmarkThreadId;
+
+    std::array<PhaseStatistics, static_cast<size_t>( Game::Benchmark::Phase::COUNT )> phaseStatistics;
+
+    const char * PhaseName( const Game::Benchmark::Phase phase )
+    {
+        switch ( phase ) {
+        case Game::Benchmark::Phase::NEW_DAY:
+            return "World::NewDay";
+        case Game::Benchmark::Phase::KINGDOM_TURN:
+            return "AI kingdom turn";
+        case Game::Benchmark::Phase::HERO_MOVE:
+            return "  AI hero move";
+        case Game::Benchmark::Phase::BATTLE:
+            return "    Battle";
+        case Game::Benchmark::Phase::BATTLE_PLANNER:
+            return "      BattlePlanner";
+        case Game::Benchmark::Phase::BATTLE_PATHFINDER:
+            return "      ArenaPathfinder";
+        case Game::Benchmark::Phase::BATTLE_SCAN_PASSABILITY:
+            return "      SetScanPassability";
+        default:
+            break;
+        }
+
+        return "Unknown";
+    }
+
+    bool LoadGameFile( const std::string & fileName )
+    {
+        Settings & conf = Settings::Get();
+        conf.SetGameType( Game::TYPE_STANDARD );
+
+        const std::string lower = StringLower( fileName );
+        const std::string extension = lower.size() > 3 ? lower.substr( lower.size() - 3 ) : std::string();
+
+        if ( extension == "mp2" || extension == "mx2" ) {
+            Maps::FileInfo fileInfo;
+            if ( !fileInfo.ReadMP2( fileName ) ) {
+                ERROR_LOG( "Failed to read map " << fileName );
+                return false;
+            }
+
+            conf.SetCurrentFileInfo( fileInfo );
+            conf.GetPlayers().SetStartGame();
+
+            for ( Player * player : conf.GetPlayers() ) {
+                player->SetControl( CONTROL_AI );
+            }
+
+            if ( !world.LoadMapMP2( fileName ) ) {
+                ERROR_LOG( "Failed to load map " << fileName );
+                return false;
+            }
+
+            return true;
+        }
+
+        if ( Game::Load( fileName ) == fheroes2::GameMode::CANCEL ) {
+            ERROR_LOG( "Failed to load saved game " << fileName );
+            return false;
+        }
+
+        for ( Player * player : conf.GetPlayers() ) {
+            player->SetControl( CONTROL_AI );
+        }
+
+        return true;
+    }
+
+    // Gives access to the internals of the player's pathfinder to compare the results of different searches
+    class PathfinderCheck : public PlayerWorldPathfinder
+    {
+    public:
+        // Evaluates the whole map for the given hero, either with the regular search or with the reference breadth-first scan which
+        // re-queues every improved tile until nothing changes
+        void evaluate( const Heroes & hero, const bool useReferenceScan )
+        {
+            reset();
+
+            _pathStart = hero.GetIndex();
+            _pathfindingSkill = static_cast<uint8_t>( hero.GetLevelSkill( Skill::Secondary::PATHFINDING ) );
+            _currentColor = hero.GetColor();
+            _remainingMovePoints = hero.GetMovePoints();
+            _maxMovePoints = hero.GetMaxMovePoints();
+
+            if ( !useReferenceScan ) {
+                processWorldMap();
+                return;
+            }
+
+            for ( WorldNode & node : _cache ) {
+                node.resetNode();
+            }
+            _cache[_pathStart] = WorldNode( -1, 0, MP2::MapObjectType::OBJ_ZERO, _remainingMovePoints );
+
+            std::vector<int> nodesToExplore;
+            nodesToExplore.push_back( _pathStart );
+            for ( size_t lastProcessedNode = 0; lastProcessedNode < nodesToExplore.size(); ++lastProcessedNode ) {
+                processCurrentNode( nodesToExplore, nodesToExplore[lastProcessedNode] );
+            }
+        }
+
+        bool isReachable( const int index ) const
+        {
+            return index == _pathStart || _cache[index]._from != -1;
+        }
+    };
+
+    // Compares the results of the regular search with the results of the reference scan. Returns the number of tiles with different results.
+    // Routes of the same cost may legitimately differ, they are only counted.
+    size_t CheckSearchResults( const Heroes & hero )
+    {
+        PathfinderCheck search;
+        PathfinderCheck reference;
+        search.evaluate( hero, false );
+        reference.evaluate( hero, true );
+
+        size_t failures = 0;
+        size_t alternativeRoutes = 0;
+
+        for ( int32_t index = 0; index < world.w() * world.h(); ++index ) {
+            const WorldNode & node = search.getNode( index );
+            const WorldNode & referenceNode = reference.getNode( index );
+
+            if ( search.isReachable( index ) != reference.isReachable( index ) || node._cost != referenceNode._cost
+                 || node._remainingMovePoints != referenceNode._remainingMovePoints || node._objectID != referenceNode._objectID ) {
+                COUT( hero.GetName() << ": tile " << index << " differs, cost " << node._cost << " (expected " << referenceNode._cost << "), remaining move points "
+                                     << node._remainingMovePoints << " (expected " << referenceNode._remainingMovePoints << ")" );
+                ++failures;
+            }
+            else if ( node._from != referenceNode._from ) {
+                ++alternativeRoutes;
+            }
+        }
+
+        if ( alternativeRoutes > 0 ) {
+            COUT( hero.GetName() << ": " << alternativeRoutes << " tiles are reached along other routes of the same cost" );
+        }
+
+        return failures;
+    }
+
+    // Moves the hero to the nearest tile next to the fog and checks that the world pathfinder, which repairs its previous results, agrees
+    // with a fresh search about the reachability of every tile afterwards. Returns the number of tiles with different results.
+    size_t CheckFogRevealResults( Heroes & hero )
+    {
+        const int color = hero.GetColor();
+        const int32_t mapSize = world.w() * world.h();
+
+        // Evaluate the world pathfinder from the current position so its results are repaired after the move instead of being rebuilt
+        world.getDistance( hero, hero.GetIndex() );
+
+        PathfinderCheck search;
+        search.evaluate( hero, false );
+
+        int32_t destination = -1;
+
+        for ( int32_t index = 0; index < mapSize; ++index ) {
+            const WorldNode & node = search.getNode( index );
+            if ( node._from == -1 || node._cost > hero.GetMovePoints() || node._objectID != MP2::OBJ_ZERO
+                 || world.GetTiles( index ).GetObject() != MP2::OBJ_ZERO || !Maps::GetTilesUnderProtection( index ).empty() ) {
+                continue;
+            }
+
+            if ( destination != -1 && node._cost >= search.getNode( destination )._cost ) {
+                continue;
+            }
+
+            const MapsIndexes around = Maps::getAroundIndexes( index );
+            if ( std::any_of( around.begin(), around.end(), [color]( const int32_t idx ) { return world.GetTiles( idx ).isFog( color ); } ) ) {
+                destination = index;
+            }
+        }
+
+        if ( destination == -1 ) {
+            COUT( hero.GetName() << ": no tile next to the fog can be reached this turn, the fog check is skipped" );
+            return 0;
+        }
+
+        std::vector<int32_t> foggedTiles;
+        for ( int32_t index = 0; index < mapSize; ++index ) {
+            if ( world.GetTiles( index ).isFog( color ) ) {
+                foggedTiles.push_back( index );
+            }
+        }
+
+        hero.calculatePath( destination );
+        hero.SetMove( true );
+        while ( hero.isMoveEnabled() && hero.GetIndex() != destination && !hero.isFreeman() ) {
+            hero.Move( true );
+        }
+
+        if ( hero.GetIndex() != destination ) {
+            COUT( hero.GetName() << ": failed to move to tile " << destination << ", the fog check is skipped" );
+            return 0;
+        }
+
+        search.evaluate( hero, false );
+
+        size_t failures = 0;
+
+        for ( int32_t index = 0; index < mapSize; ++index ) {
+            const bool isReachable = index == hero.GetIndex() || world.getDistance( hero, index ) > 0;
+            if ( isReachable != search.isReachable( index ) ) {
+                COUT( hero.GetName() << ": tile " << index << " is " << ( isReachable ? "reachable" : "unreachable" ) << " after the move, expected "
+                                     << ( search.isReachable( index ) ? "reachable" : "unreachable" ) );
+                ++failures;
+            }
+        }
+
+        const bool isAnyRevealedTileReachable = std::any_of( foggedTiles.begin(), foggedTiles.end(), [&hero, color]( const int32_t idx ) {
+            return !world.GetTiles( idx ).isFog( color ) && world.getDistance( hero, idx ) > 0;
+        } );
+        if ( !isAnyRevealedTileReachable ) {
+            COUT( hero.GetName() << ": none of the tiles revealed by the move to tile " << destination << " is reachable, the fog check is inconclusive" );
+        }
+
+        return failures;
+    }
+
+    void StartBenchmark()
+    {
+        phaseStatistics.fill( PhaseStatistics() );
+        benchmarkThreadId = std::this_thread::get_id();
+        isBenchmarkRunning = true;
+    }
+
+    void PrintPhaseStatistics( const Game::Benchmark::Phase firstPhase )
+    {
+        for ( size_t i = static_cast<size_t>( firstPhase ); i < phaseStatistics.size(); ++i ) {
+            const PhaseStatistics & stats = phaseStatistics[i];
+
+            std::ostringstream os;
+            os << std::left << std::setw( 26 ) << PhaseName( static_cast<Game::Benchmark::Phase>( i ) ) << std::right << std::fixed << std::setprecision( 3 )
+               << std::setw( 10 ) << stats.time << " s" << std::setw( 10 ) << stats.count << " calls";
+            if ( stats.count > 0 ) {
+                os << std::setw( 12 ) << stats.time * 1000 / stats.count << " ms per call";
+            }
+
+            COUT( os.str() );
+        }
+    }
+
+    void PrintStatistics( const uint32_t days, const double totalTime )
+    {
+        COUT( "Days played: " << days << ", total time: " << std::fixed << std::setprecision( 3 ) << totalTime << " s" );
+        if ( days > 0 && totalTime > 0 ) {
+            COUT( "Days per second: " << std::fixed << std::setprecision( 3 ) << days / totalTime );
+        }
+
+        PrintPhaseStatistics( Game::Benchmark::Phase::NEW_DAY );
+    }
+
+    void PrintBattleStatistics( const std::vector<BattleStatistics> & battleStatistics )
+    {
+        uint32_t battles = 0;
+        double totalTime = 0;
+        size_t outcomeHash = 0;
+
+        for ( const BattleStatistics & stats : battleStatistics ) {
+            battles += stats.count;
+            totalTime += stats.time;
+            fheroes2::hashCombine( outcomeHash, stats.outcomeHash );
+        }
+
+        COUT( "Battles played: " << battles << ", total time: " << std::fixed << std::setprecision( 3 ) << totalTime << " s" );
+        if ( battles > 0 && totalTime > 0 ) {
+            COUT( "Battles per second: " << std::fixed << std::setprecision( 3 ) << battles / totalTime );
+        }
+
+        PrintPhaseStatistics( Game::Benchmark::Phase::BATTLE );
+
+        for ( size_t id = 0; id < battleStatistics.size(); ++id ) {
+            const BattleStatistics & stats = battleStatistics[id];
+
+            std::ostringstream os;
+            os << std::left << std::setw( 32 ) << Battle::Only::GetBenchmarkBattleName( id ) << std::right;
+            if ( stats.count > 0 ) {
+                os << std::fixed << std::setprecision( 3 ) << std::setw( 10 ) << stats.time * 1000 / stats.count << " ms per battle, outcome hash: " << std::hex
+                   << stats.outcomeHash;
+            }
+            else {
+                os << "    skipped";
+            }
+
+            COUT( os.str() );
+        }
+
+        COUT( "Total outcome hash: " << std::hex << outcomeHash );
+    }
+}
+
+namespace Game
+{
+    namespace Benchmark
+    {
+        PhaseTimer::PhaseTimer( const Phase phase )
+            : _phase( phase )
+            , _isActive( isBenchmarkRunning && std::this_thread::get_id() == benchmarkThreadId )
+        {
+            if ( _isActive ) {
+                _startTime = std::chrono::steady_clock::now();
+            }
+        }
+
+        PhaseTimer::~PhaseTimer()
+        {
+            if ( !_isActive || !isBenchmarkRunning ) {
+                return;
+            }
+
+            PhaseStatistics & stats = phaseStatistics[static_cast<size_t>( _phase )];
+            stats.time += std::chrono::duration<double>( std::chrono::steady_clock::now() - _startTime ).count();
+            ++stats.count;
+        }
+
+        int RunAIGame( const std::string & fileName, const uint32_t days, const uint32_t seed )
+        {
+            // Everything that depends on random numbers (including the map loading) must be done after this call.
+            Rand::CurrentThreadRandomDevice().seed( seed );
+
+            if ( !LoadGameFile( fileName ) ) {
+                return EXIT_FAILURE;
+            }
+
+            Settings & conf = Settings::Get();
+
+            // No animation at all.
+            conf.SetAIMoveSpeed( 0 );
+
+            AI::Get().Reset();
+
+            std::vector<Player *> players = conf.GetPlayers();
+            std::sort( players.begin(), players.end(), []( const Player * player1, const Player * player2 ) { return player1->GetColor() < player2->GetColor(); } );
+
+            bool loadedFromSave = conf.LoadedGameVersion();
+            bool skipTurns = loadedFromSave;
+
+            StartBenchmark();
+
+            const fheroes2::Time totalTimer;
+            uint32_t daysPlayed = 0;
+
+            while ( daysPlayed < days ) {
+                if ( !loadedFromSave ) {
+                    const PhaseTimer timer( Phase::NEW_DAY );
+                    world.NewDay();
+                }
+
+                for ( const Player * player : players ) {
+                    if ( skipTurns && !player->isColor( conf.CurrentColor() ) ) {
+                        continue;
+                    }
+
+                    skipTurns = false;
+
+                    Kingdom & kingdom = world.GetKingdom( player->GetColor() );
+                    if ( !kingdom.isPlay() ) {
+                        continue;
+                    }
+
+                    DEBUG_LOG( DBG_GAME, DBG_INFO, world.DateString() << ", color: " << Color::String( player->GetColor() ) );
+
+                    conf.SetCurrentColor( player->GetColor() );
+                    world.ClearFog( player->GetColor() );
+                    kingdom.ActionBeforeTurn();
+
+                    const PhaseTimer timer( Phase::KINGDOM_TURN );
+                    AI::Get().KingdomTurn( kingdom );
+                }
+
+                loadedFromSave = false;
+                ++daysPlayed;
+
+                const size_t kingdomsInPlay = std::count_if( players.begin(), players.end(),
+                                                             []( const Player * player ) { return world.GetKingdom( player->GetColor() ).isPlay(); } );
+                if ( kingdomsInPlay < 2 ) {
+                    COUT( "The game is over on " << world.DateString() );
+                    break;
+                }
+            }
+
+            const double totalTime = totalTimer.get();
+            isBenchmarkRunning = false;
+
+            PrintStatistics( daysPlayed, totalTime );
+
+            return EXIT_SUCCESS;
+        }
+
+        int RunBattles( const std::string & fileName, const uint32_t rounds, const uint32_t seed )
+        {
+            Settings & conf = Settings::Get();
+
+            AI::Get().Reset();
+
+            const size_t battleCount = Battle::Only::GetBenchmarkBattleCount();
+            std::vector<BattleStatistics> battleStatistics( battleCount );
+
+            StartBenchmark();
+
+            for ( uint32_t round = 0; round < rounds; ++round ) {
+                for ( size_t id = 0; id < battleCount; ++id ) {
+                    const bool isSiege = Battle::Only::isBenchmarkSiege( id );
+                    if ( isSiege && fileName.empty() ) {
+                        continue;
+                    }
+
+                    // Every battle starts from a fresh world with its own fixed seed so battles don't depend on each other.
+                    Rand::CurrentThreadRandomDevice().seed( seed + round * static_cast<uint32_t>( battleCount ) + static_cast<uint32_t>( id ) );
+
+                    if ( isSiege ) {
+                        if ( !LoadGameFile( fileName ) ) {
+                            isBenchmarkRunning = false;
+                            return EXIT_FAILURE;
+                        }
+                    }
+                    else {
+                        conf.SetGameType( Game::TYPE_BATTLEONLY );
+                        world.NewMaps( 10, 10 );
+                    }
+
+                    Battle::Only battle;
+                    if ( !battle.SetupBenchmarkBattle( id ) ) {
+                        if ( round == 0 ) {
+                            ERROR_LOG( "The battle '" << Battle::Only::GetBenchmarkBattleName( id ) << "' can't be played on the map " << fileName );
+                        }
+                        continue;
+                    }
+
+                    const fheroes2::Time timer;
+                    const Battle::Result result = battle.StartBattle();
+
+                    BattleStatistics & stats = battleStatistics[id];
+                    stats.time += timer.get();
+                    ++stats.count;
+                    fheroes2::hashCombine( stats.outcomeHash, battle.GetOutcomeHash( result ) );
+                }
+            }
+
+            isBenchmarkRunning = false;
+
+            PrintBattleStatistics( battleStatistics );
+
+            return EXIT_SUCCESS;
+        }
+
+        int RunPathfinderChecks( const std::string & fileName )
+        {
+            Rand::CurrentThreadRandomDevice().seed( 0 );
+
+            if ( !LoadGameFile( fileName ) ) {
+                return EXIT_FAILURE;
+            }
+
+            AI::Get().Reset();
+
+            size_t heroCount = 0;
+            size_t failures = 0;
+
+            for ( const Player * player : Settings::Get().GetPlayers() ) {
+                // Heroes may move during the checks, so the list is copied
+                const VecHeroes heroes = world.GetKingdom( player->GetColor() ).GetHeroes();
+
+                for ( Heroes * hero : heroes ) {
+                    ++heroCount;
+                    failures += CheckSearchResults( *hero );
+                    failures += CheckFogRevealResults( *hero );
+                }
+            }
+
+            COUT( "Heroes checked: " << heroCount << ", failed checks: " << failures );
+
+            return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/***************************************************************************
+ *   Free Heroes of Might and Magic II: https://github.com/ihhub/fheroes2  *
+ *   Copyright (C) 2021                                                    *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Game
+{
+    namespace Benchmark
+    {
+        enum class Phase : int
+        {
+            NEW_DAY,
+            KINGDOM_TURN,
+            HERO_MOVE,
+            BATTLE,
+            BATTLE_PLANNER,
+            BATTLE_PATHFINDER,
+            BATTLE_SCAN_PASSABILITY,
+
+            COUNT
+        };
+
+        // Measures the time spent in the given phase while a benchmark is running. Does nothing during a normal game and on threads other than
+        // the one running the benchmark: the clock is read only when the time is measured.
+        class PhaseTimer
+        {
+        public:
+            explicit PhaseTimer( const Phase phase );
+            PhaseTimer( const PhaseTimer & ) = delete;
+            PhaseTimer & operator=( const PhaseTimer & ) = delete;
+            ~PhaseTimer();
+
+        private:
+            const Phase _phase;
+            const bool _isActive;
+            std::chrono::steady_clock::time_point _startTime;
+        };
+
+        // Plays the map or the saved game from the given file for the given number of days. All kingdoms are controlled by AI and nothing is
+        // rendered. Timings of every phase are printed at the end. Returns the exit code of the application.
+        int RunAIGame( const std::string & fileName, const uint32_t days, const uint32_t seed );
+
+        // Plays every battle of the Battle::Only benchmark catalog the given number of rounds with fixed seeds. Castle sieges are played on the
+        // given map and skipped without it. Timings and outcome hashes of every battle are printed at the end. Returns the exit code of the application.
+        int RunBattles( const std::string & fileName, const uint32_t rounds, const uint32_t seed );
+
+        // Runs consistency checks of the world pathfinder on the map or the saved game from the given file for every hero on it. Differences
+        // are printed. Returns EXIT_FAILURE if any check fails.
+        int RunPathfinderChecks( const std::string & fileName );
+    }
+}
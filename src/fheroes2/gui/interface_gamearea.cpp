@@ -36,8 +36,69 @@
 #include "tools.h"
 #include "world.h"
 
+#include <algorithm>
 #include <cassert>
 
+namespace
+{
+    // Sprites of bottom level objects never reach further than this number of tiles from their own tile
+    const int32_t bottomLayerTileMargin = 2;
+
+    // Beyond this number the chunks not used for the longest time are removed from the cache
+    const size_t maxCachedChunks = 16;
+
+    // Unlike integer division rounds negative values down
+    int32_t divideFloor( const int32_t value, const int32_t divisor )
+    {
+        return ( value >= 0 ) ? value / divisor : ( value - divisor + 1 ) / divisor;
+    }
+
+    bool isBottomLayerHidden( const Maps::Tiles & tile, const bool drawFog, const int friendColors )
+    {
+        return drawFog && tile.isFog( friendColors ) && tile.isFogAllAround( friendColors );
+    }
+
+    size_t getBottomLayerHash( const int32_t x, const int32_t y, const bool drawFog, const int friendColors )
+    {
+        // Tiles outside of the world never change
+        if ( x < 0 || y < 0 || x >= world.w() || y >= world.h() ) {
+            return 0;
+        }
+
+        const Maps::Tiles & tile = world.GetTiles( x, y );
+
+        size_t hash = tile.GetBottomLayerHash();
+        fheroes2::hashCombine( hash, isBottomLayerHidden( tile, drawFog, friendColors ) );
+
+        return hash;
+    }
+}
+
+Interface::GameArea::LayerCache::LayerCache()
+    : frame( 0 )
+    , friendColors( 0 )
+    , drawFog( false )
+    , isEnabled( true )
+{}
+
+Interface::GameArea::LayerCache::LayerCache( const LayerCache & )
+    : frame( 0 )
+    , friendColors( 0 )
+    , drawFog( false )
+    , isEnabled( false )
+{}
+
+Interface::GameArea::LayerCache & Interface::GameArea::LayerCache::operator=( const LayerCache & )
+{
+    reset();
+    return *this;
+}
+
+void Interface::GameArea::LayerCache::reset()
+{
+    chunks.clear();
+}
+
 Interface::GameArea::GameArea( Basic & basic )
     : interface( basic )
     , _minLeftOffset( 0 )
@@ -77,6 +138,8 @@ void Interface::GameArea::generate( const fheroes2::Size & screenSize, const boo
 void Interface::GameArea::SetAreaPosition( int32_t x, int32_t y, int32_t w, int32_t h )
 {
     _windowROI = fheroes2::Rect( x, y, w, h );
+    _layerCache.reset();
+
     const fheroes2::Size worldSize( world.w() * TILEWIDTH, world.h() * TILEWIDTH );
 
     if ( worldSize.width > w ) {
@@ -127,6 +190,28 @@ void Interface::GameArea::BlitOnTile( fheroes2::Image & dst, const fheroes2::Ima
     }
 }
 
+void Interface::GameArea::BlitOnTile( fheroes2::Image & dst, const fheroes2::PackedSprite & src, int32_t ox, int32_t oy, const fheroes2::Point & mp ) const
+{
+    fheroes2::Point dstpt = GetRelativeTilePosition( mp ) + fheroes2::Point( ox, oy );
+
+    const int32_t width = src.width();
+    const int32_t height = src.height();
+
+    if ( dstpt.x >= _windowROI.x && dstpt.y >= _windowROI.y && dstpt.x + width <= _windowROI.x + _windowROI.width
+         && dstpt.y + height <= _windowROI.y + _windowROI.height ) {
+        fheroes2::Blit( src, 0, 0, dst, dstpt.x, dstpt.y, width, height );
+    }
+    else if ( _windowROI & fheroes2::Rect( dstpt.x, dstpt.y, width, height ) ) {
+        const fheroes2::Rect & fixedRect = RectFixed( dstpt, width, height );
+        fheroes2::Blit( src, fixedRect.x, fixedRect.y, dst, dstpt.x, dstpt.y, fixedRect.width, fixedRect.height );
+    }
+}
+
+void Interface::GameArea::BlitOnTile( fheroes2::Image & dst, const fheroes2::PackedSprite & src, const fheroes2::Point & mp ) const
+{
+    BlitOnTile( dst, src, src.x(), src.y(), mp );
+}
+
 void Interface::GameArea::DrawTile( fheroes2::Image & dst, const fheroes2::Image & src, const fheroes2::Point & mp ) const
 {
     fheroes2::Point dstpt = GetRelativeTilePosition( mp );
@@ -154,22 +239,41 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
     int32_t maxX = tileROI.x + tileROI.width;
     int32_t maxY = tileROI.y + tileROI.height;
 
-    // Ground level. Also find range of X and Y tile positions.
-    for ( int32_t y = 0; y < tileROI.height; ++y ) {
-        fheroes2::Point offset( tileROI.x, tileROI.y + y );
+    const bool drawBottom = ( flag & LEVEL_BOTTOM ) == LEVEL_BOTTOM;
+    const bool drawMonstersAndBoats = ( flag & LEVEL_OBJECTS ) && !isPuzzleDraw;
+    const bool drawHeroes = ( flag & LEVEL_HEROES ) == LEVEL_HEROES;
+    const bool drawTop = ( flag & LEVEL_TOP ) == LEVEL_TOP;
+#ifdef WITH_DEBUG
+    const bool drawFog = ( ( flag & LEVEL_FOG ) == LEVEL_FOG ) && !IS_DEVEL();
+#else
+    const bool drawFog = ( flag & LEVEL_FOG ) == LEVEL_FOG;
+#endif
 
-        if ( offset.y < 0 || offset.y >= world.h() ) {
-            for ( ; offset.x < maxX; ++offset.x ) {
-                Maps::Tiles::RedrawEmptyTile( dst, offset, tileROI, *this );
-            }
-        }
-        else {
-            for ( ; offset.x < maxX; ++offset.x ) {
-                if ( offset.x < 0 || offset.x >= world.w() ) {
+    const int friendColors = Players::FriendColors();
+
+    // Ground level and bottom level objects come from the cache in the adventure map
+    const bool useLayerCache = _layerCache.isEnabled && drawBottom && !isPuzzleDraw;
+    if ( useLayerCache ) {
+        _redrawCachedLayers( dst, drawFog, friendColors );
+    }
+    else {
+        // Ground level.
+        for ( int32_t y = 0; y < tileROI.height; ++y ) {
+            fheroes2::Point offset( tileROI.x, tileROI.y + y );
+
+            if ( offset.y < 0 || offset.y >= world.h() ) {
+                for ( ; offset.x < maxX; ++offset.x ) {
                     Maps::Tiles::RedrawEmptyTile( dst, offset, tileROI, *this );
                 }
-                else {
-                    world.GetTiles( offset.x, offset.y ).RedrawTile( dst, tileROI, *this );
+            }
+            else {
+                for ( ; offset.x < maxX; ++offset.x ) {
+                    if ( offset.x < 0 || offset.x >= world.w() ) {
+                        Maps::Tiles::RedrawEmptyTile( dst, offset, tileROI, *this );
+                    }
+                    else {
+                        world.GetTiles( offset.x, offset.y ).RedrawTile( dst, tileROI, *this );
+                    }
                 }
             }
         }
@@ -201,18 +305,6 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
     objectList.reserve( areaSize );
 
     // Bottom layer and objects.
-    const bool drawBottom = ( flag & LEVEL_BOTTOM ) == LEVEL_BOTTOM;
-    const bool drawMonstersAndBoats = ( flag & LEVEL_OBJECTS ) && !isPuzzleDraw;
-    const bool drawHeroes = ( flag & LEVEL_HEROES ) == LEVEL_HEROES;
-    const bool drawTop = ( flag & LEVEL_TOP ) == LEVEL_TOP;
-#ifdef WITH_DEBUG
-    const bool drawFog = ( ( flag & LEVEL_FOG ) == LEVEL_FOG ) && !IS_DEVEL();
-#else
-    const bool drawFog = ( flag & LEVEL_FOG ) == LEVEL_FOG;
-#endif
-
-    const int friendColors = Players::FriendColors();
-
     for ( int32_t y = minY; y < maxY; ++y ) {
         for ( int32_t x = minX; x < maxX; ++x ) {
             const Maps::Tiles & tile = world.GetTiles( x, y );
@@ -225,12 +317,15 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
                 }
             }
 
+            if ( drawBottom && !useLayerCache ) {
+                tile.RedrawBottom( dst, tileROI, isPuzzleDraw, *this );
+            }
+
             const MP2::MapObjectType objectType = tile.GetObject();
 
             switch ( objectType ) {
             case MP2::OBJ_ZERO: {
                 if ( drawBottom ) {
-                    tile.RedrawBottom( dst, tileROI, isPuzzleDraw, *this );
                     const uint8_t objectTileset = tile.GetObjectTileset();
                     const int icn = MP2::GetICNObject( objectTileset );
                     if ( ICN::UNKNOWN != icn && ( !isPuzzleDraw || !MP2::isHiddenForPuzzle( objectTileset, tile.GetObjectSpriteIndex() ) ) ) {
@@ -243,9 +338,6 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
                 break;
             }
             case MP2::OBJ_BOAT: {
-                if ( drawBottom ) {
-                    tile.RedrawBottom( dst, tileROI, isPuzzleDraw, *this );
-                }
                 if ( drawMonstersAndBoats ) {
                     drawList.emplace_back( &tile );
                 }
@@ -255,9 +347,6 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
                 break;
             }
             case MP2::OBJ_MONSTER: {
-                if ( drawBottom ) {
-                    tile.RedrawBottom( dst, tileROI, isPuzzleDraw, *this );
-                }
                 if ( drawTop ) {
                     topList.emplace_back( &tile );
                 }
@@ -268,7 +357,6 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
             }
             case MP2::OBJ_HEROES: {
                 if ( drawBottom ) {
-                    tile.RedrawBottom( dst, tileROI, isPuzzleDraw, *this );
                     if ( !isPuzzleDraw || !MP2::isHiddenForPuzzle( tile.GetObjectTileset(), tile.GetObjectSpriteIndex() ) ) {
                         objectList.emplace_back( &tile );
                     }
@@ -287,7 +375,6 @@ void Interface::GameArea::Redraw( fheroes2::Image & dst, int flag, bool isPuzzle
             }
             default: {
                 if ( drawBottom ) {
-                    tile.RedrawBottom( dst, tileROI, isPuzzleDraw, *this );
                     if ( !isPuzzleDraw || !MP2::isHiddenForPuzzle( tile.GetObjectTileset(), tile.GetObjectSpriteIndex() ) ) {
                         objectList.emplace_back( &tile );
                     }
@@ -732,3 +819,183 @@ fheroes2::Point Interface::GameArea::getCurrentCenterInPixels() const
 {
     return _topLeftTileOffset + _middlePoint();
 }
+
+void Interface::GameArea::_redrawCachedLayers( fheroes2::Image & dst, const bool drawFog, const int friendColors ) const
+{
+    if ( _layerCache.drawFog != drawFog || _layerCache.friendColors != friendColors ) {
+        _layerCache.reset();
+        _layerCache.drawFog = drawFog;
+        _layerCache.friendColors = friendColors;
+    }
+
+    ++_layerCache.frame;
+
+    const int32_t chunkWidth = _windowROI.width;
+    const int32_t chunkHeight = _windowROI.height;
+    const fheroes2::Rect visibleArea( _topLeftTileOffset.x, _topLeftTileOffset.y, _windowROI.width, _windowROI.height );
+
+    const int32_t minChunkX = divideFloor( visibleArea.x, chunkWidth );
+    const int32_t minChunkY = divideFloor( visibleArea.y, chunkHeight );
+    const int32_t maxChunkX = divideFloor( visibleArea.x + visibleArea.width - 1, chunkWidth );
+    const int32_t maxChunkY = divideFloor( visibleArea.y + visibleArea.height - 1, chunkHeight );
+
+    std::vector<uint8_t> dirtyTiles;
+
+    for ( int32_t chunkY = minChunkY; chunkY <= maxChunkY; ++chunkY ) {
+        for ( int32_t chunkX = minChunkX; chunkX <= maxChunkX; ++chunkX ) {
+            LayerCache::Chunk & chunk = _getCachedChunk( fheroes2::Point( chunkX * chunkWidth, chunkY * chunkHeight ), drawFog, friendColors );
+            chunk.lastUsedFrame = _layerCache.frame;
+
+            const fheroes2::Rect chunkArea( chunk.offset.x, chunk.offset.y, chunkWidth, chunkHeight );
+            const fheroes2::Rect usedArea = chunkArea ^ visibleArea;
+            if ( usedArea.width <= 0 || usedArea.height <= 0 ) {
+                continue;
+            }
+
+            // Look for changes only among the tiles which can draw within the visible part of the chunk. The rest is checked once it becomes visible.
+            const fheroes2::Rect & tileROI = chunk.tileROI;
+            const int32_t minX = std::max( divideFloor( usedArea.x, TILEWIDTH ) - bottomLayerTileMargin, tileROI.x );
+            const int32_t minY = std::max( divideFloor( usedArea.y, TILEWIDTH ) - bottomLayerTileMargin, tileROI.y );
+            const int32_t maxX = std::min( divideFloor( usedArea.x + usedArea.width - 1, TILEWIDTH ) + 1 + bottomLayerTileMargin, tileROI.x + tileROI.width );
+            const int32_t maxY = std::min( divideFloor( usedArea.y + usedArea.height - 1, TILEWIDTH ) + 1 + bottomLayerTileMargin, tileROI.y + tileROI.height );
+
+            dirtyTiles.assign( chunk.tileHashes.size(), 0 );
+            bool isChanged = false;
+
+            for ( int32_t y = minY; y < maxY; ++y ) {
+                for ( int32_t x = minX; x < maxX; ++x ) {
+                    size_t & hash = chunk.tileHashes[( y - tileROI.y ) * tileROI.width + x - tileROI.x];
+                    const size_t newHash = getBottomLayerHash( x, y, drawFog, friendColors );
+                    if ( hash == newHash ) {
+                        continue;
+                    }
+
+                    hash = newHash;
+                    isChanged = true;
+
+                    // Objects of the tile can be drawn over its neighbours
+                    const int32_t dirtyMinX = std::max( x - bottomLayerTileMargin, tileROI.x ) - tileROI.x;
+                    const int32_t dirtyMaxX = std::min( x + bottomLayerTileMargin + 1, tileROI.x + tileROI.width ) - tileROI.x;
+                    const int32_t dirtyMinY = std::max( y - bottomLayerTileMargin, tileROI.y ) - tileROI.y;
+                    const int32_t dirtyMaxY = std::min( y + bottomLayerTileMargin + 1, tileROI.y + tileROI.height ) - tileROI.y;
+
+                    for ( int32_t dirtyY = dirtyMinY; dirtyY < dirtyMaxY; ++dirtyY ) {
+                        uint8_t * dirtyRow = dirtyTiles.data() + dirtyY * tileROI.width;
+                        std::fill( dirtyRow + dirtyMinX, dirtyRow + dirtyMaxX, static_cast<uint8_t>( 1 ) );
+                    }
+                }
+            }
+
+            // Render changed areas again row by row joining neighbouring tiles together
+            for ( int32_t y = 0; y < tileROI.height && isChanged; ++y ) {
+                const uint8_t * dirtyRow = dirtyTiles.data() + y * tileROI.width;
+
+                int32_t x = 0;
+                while ( x < tileROI.width ) {
+                    if ( dirtyRow[x] == 0 ) {
+                        ++x;
+                        continue;
+                    }
+
+                    const int32_t startX = x;
+                    while ( x < tileROI.width && dirtyRow[x] != 0 ) {
+                        ++x;
+                    }
+
+                    const fheroes2::Rect dirtyArea( ( tileROI.x + startX ) * TILEWIDTH, ( tileROI.y + y ) * TILEWIDTH, ( x - startX ) * TILEWIDTH, TILEWIDTH );
+                    const fheroes2::Rect area = chunkArea ^ dirtyArea;
+                    if ( area.width > 0 && area.height > 0 ) {
+                        _renderChunkArea( chunk, area, drawFog, friendColors );
+                    }
+                }
+            }
+
+            fheroes2::Copy( chunk.image, usedArea.x - chunk.offset.x, usedArea.y - chunk.offset.y, dst, usedArea.x - _topLeftTileOffset.x + _windowROI.x,
+                            usedArea.y - _topLeftTileOffset.y + _windowROI.y, usedArea.width, usedArea.height );
+        }
+    }
+}
+
+Interface::GameArea::LayerCache::Chunk & Interface::GameArea::_getCachedChunk( const fheroes2::Point & offset, const bool drawFog, const int friendColors ) const
+{
+    std::vector<LayerCache::Chunk> & chunks = _layerCache.chunks;
+
+    for ( LayerCache::Chunk & chunk : chunks ) {
+        if ( chunk.offset == offset ) {
+            return chunk;
+        }
+    }
+
+    if ( chunks.size() >= maxCachedChunks ) {
+        chunks.erase( std::min_element( chunks.begin(), chunks.end(), []( const LayerCache::Chunk & first, const LayerCache::Chunk & second ) {
+            return first.lastUsedFrame < second.lastUsedFrame;
+        } ) );
+    }
+
+    chunks.emplace_back();
+
+    LayerCache::Chunk & chunk = chunks.back();
+    chunk.offset = offset;
+    chunk.image.resize( _windowROI.width, _windowROI.height );
+    chunk.lastUsedFrame = _layerCache.frame;
+
+    const int32_t minX = divideFloor( offset.x, TILEWIDTH ) - bottomLayerTileMargin;
+    const int32_t minY = divideFloor( offset.y, TILEWIDTH ) - bottomLayerTileMargin;
+    const int32_t maxX = divideFloor( offset.x + _windowROI.width - 1, TILEWIDTH ) + 1 + bottomLayerTileMargin;
+    const int32_t maxY = divideFloor( offset.y + _windowROI.height - 1, TILEWIDTH ) + 1 + bottomLayerTileMargin;
+    chunk.tileROI = fheroes2::Rect( minX, minY, maxX - minX, maxY - minY );
+
+    chunk.tileHashes.resize( static_cast<size_t>( chunk.tileROI.width * chunk.tileROI.height ) );
+    size_t * hash = chunk.tileHashes.data();
+    for ( int32_t y = minY; y < maxY; ++y ) {
+        for ( int32_t x = minX; x < maxX; ++x, ++hash ) {
+            *hash = getBottomLayerHash( x, y, drawFog, friendColors );
+        }
+    }
+
+    _renderChunkArea( chunk, fheroes2::Rect( offset.x, offset.y, _windowROI.width, _windowROI.height ), drawFog, friendColors );
+
+    return chunk;
+}
+
+void Interface::GameArea::_renderChunkArea( LayerCache::Chunk & chunk, const fheroes2::Rect & area, const bool drawFog, const int friendColors ) const
+{
+    // A temporary copy of the game area clips everything drawn to the given area of the chunk
+    GameArea chunkGameArea( *this );
+    chunkGameArea._windowROI = area - chunk.offset;
+    chunkGameArea._topLeftTileOffset = area.getPosition();
+
+    const int32_t minX = divideFloor( area.x, TILEWIDTH );
+    const int32_t minY = divideFloor( area.y, TILEWIDTH );
+    const int32_t maxX = divideFloor( area.x + area.width - 1, TILEWIDTH ) + 1;
+    const int32_t maxY = divideFloor( area.y + area.height - 1, TILEWIDTH ) + 1;
+
+    const fheroes2::Rect tileROI( minX - bottomLayerTileMargin, minY - bottomLayerTileMargin, maxX - minX + 2 * bottomLayerTileMargin,
+                                  maxY - minY + 2 * bottomLayerTileMargin );
+
+    // Ground tiles never go beyond their own tile
+    for ( int32_t y = minY; y < maxY; ++y ) {
+        for ( int32_t x = minX; x < maxX; ++x ) {
+            if ( x < 0 || y < 0 || x >= world.w() || y >= world.h() ) {
+                Maps::Tiles::RedrawEmptyTile( chunk.image, fheroes2::Point( x, y ), tileROI, chunkGameArea );
+            }
+            else {
+                world.GetTiles( x, y ).RedrawTile( chunk.image, tileROI, chunkGameArea );
+            }
+        }
+    }
+
+    const int32_t minObjectX = std::max( tileROI.x, 0 );
+    const int32_t minObjectY = std::max( tileROI.y, 0 );
+    const int32_t maxObjectX = std::min( tileROI.x + tileROI.width, world.w() );
+    const int32_t maxObjectY = std::min( tileROI.y + tileROI.height, world.h() );
+
+    for ( int32_t y = minObjectY; y < maxObjectY; ++y ) {
+        for ( int32_t x = minObjectX; x < maxObjectX; ++x ) {
+            const Maps::Tiles & tile = world.GetTiles( x, y );
+            if ( !isBottomLayerHidden( tile, drawFog, friendColors ) ) {
+                tile.RedrawBottom( chunk.image, tileROI, false, chunkGameArea );
+            }
+        }
+    }
+}
@@ -23,6 +23,8 @@
 #ifndef H2INTERFACE_GAMEAREA_H
 #define H2INTERFACE_GAMEAREA_H
 
+#include <vector>
+
 #include "image.h"
 #include "timing.h"
 
@@ -90,6 +92,8 @@ namespace Interface
         void BlitOnTile( fheroes2::Image & dst, const fheroes2::Image & src, int32_t ox, int32_t oy, const fheroes2::Point & mp, bool flip = false,
                          uint8_t alpha = 255 ) const;
         void BlitOnTile( fheroes2::Image & dst, const fheroes2::Sprite & src, const fheroes2::Point & mp ) const;
+        void BlitOnTile( fheroes2::Image & dst, const fheroes2::PackedSprite & src, int32_t ox, int32_t oy, const fheroes2::Point & mp ) const;
+        void BlitOnTile( fheroes2::Image & dst, const fheroes2::PackedSprite & src, const fheroes2::Point & mp ) const;
 
         // Use this method to draw TIL images
         void DrawTile( fheroes2::Image & src, const fheroes2::Image & dst, const fheroes2::Point & mp ) const;
@@ -118,6 +122,34 @@ namespace Interface
         fheroes2::Point getCurrentCenterInPixels() const;
 
     private:
+        // Ground and bottom level objects of the map pre-rendered in world aligned chunks of the window size. Every frame only the tiles
+        // whose hash has changed are rendered again. Copies of the game area (used for View World or the puzzle) start without a cache.
+        class LayerCache
+        {
+        public:
+            struct Chunk
+            {
+                fheroes2::Point offset; // in world pixels
+                fheroes2::Image image;
+                fheroes2::Rect tileROI; // tiles which can draw within the chunk
+                std::vector<size_t> tileHashes;
+                uint32_t lastUsedFrame;
+            };
+
+            LayerCache();
+            LayerCache( const LayerCache & );
+
+            LayerCache & operator=( const LayerCache & );
+
+            void reset();
+
+            std::vector<Chunk> chunks;
+            uint32_t frame;
+            int friendColors;
+            bool drawFog;
+            bool isEnabled;
+        };
+
         Basic & interface;
 
         fheroes2::Rect _windowROI; // visible to draw area of World Map in pixels
@@ -137,9 +169,16 @@ namespace Interface
 
         fheroes2::Time scrollTime;
 
+        mutable LayerCache _layerCache;
+
         fheroes2::Point _middlePoint() const; // returns middle point of window ROI
         fheroes2::Point _getStartTileId() const;
         void _setCenterToTile( const fheroes2::Point & tile ); // set center to the middle of tile (input is tile ID)
+
+        // Draws ground and bottom level objects of the visible area from the cache, updating the cache where needed
+        void _redrawCachedLayers( fheroes2::Image & dst, const bool drawFog, const int friendColors ) const;
+        LayerCache::Chunk & _getCachedChunk( const fheroes2::Point & offset, const bool drawFog, const int friendColors ) const;
+        void _renderChunkArea( LayerCache::Chunk & chunk, const fheroes2::Rect & area, const bool drawFog, const int friendColors ) const;
     };
 }
 
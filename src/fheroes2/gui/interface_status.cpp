@@ -462,6 +462,12 @@ void Interface::StatusWindow::RedrawTurnProgress( u32 v )
     turn_progress = v;
     SetRedraw();
 
+    fheroes2::Display & display = fheroes2::Display::instance();
+    if ( display.empty() ) {
+        // The game runs without a display, there is nothing to show.
+        return;
+    }
+
     interface.Redraw();
-    fheroes2::Display::instance().render();
+    display.render();
 }
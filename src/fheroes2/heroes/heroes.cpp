@@ -502,6 +502,8 @@ void Heroes::IncreasePrimarySkill( int skill )
     default:
         break;
     }
+
+    GetArmy().InvalidateCachedStrength();
 }
 
 u32 Heroes::GetExperience( void ) const
@@ -843,6 +845,9 @@ void Heroes::SetVisited( s32 index, Visit::type_t type )
     else if ( !isVisited( tile ) && MP2::OBJ_ZERO != objectType ) {
         visit_object.push_front( IndexObject( index, objectType ) );
     }
+
+    // Visited objects may affect morale and luck
+    GetArmy().InvalidateCachedStrength();
 }
 
 void Heroes::setVisitedForAllies( const int32_t tileIndex ) const
@@ -1257,8 +1262,10 @@ int Heroes::GetLevelSkill( int skill ) const
 
 void Heroes::LearnSkill( const Skill::Secondary & skill )
 {
-    if ( skill.isValid() )
+    if ( skill.isValid() ) {
         secondary_skills.AddSkill( skill );
+        GetArmy().InvalidateCachedStrength();
+    }
 }
 
 void Heroes::Scoute( const int tileIndex ) const
@@ -1355,6 +1362,8 @@ void Heroes::LevelUp( bool skipsecondary, bool autoselect )
         LevelUpSecondarySkill( seeds, primarySkill, ( autoselect || isControlAI() ) );
     if ( isControlAI() )
         AI::Get().HeroesLevelUp( *this );
+
+    GetArmy().InvalidateCachedStrength();
 }
 
 void Heroes::LevelUpSecondarySkill( const HeroSeedsForLevelUp & seeds, int primary, bool autoselect )
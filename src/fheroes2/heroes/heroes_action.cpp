@@ -372,6 +372,9 @@ void Heroes::Action( int tileIndex, bool isDestination )
     // restore the original music after the action is completed
     const Game::MusicRestorer musicRestorer;
 
+    // Army and hero state could have been changed directly (for example, by swapping artifacts in a dialog)
+    Army::InvalidateStrengthCache();
+
     if ( GetKingdom().isControlAI() )
         return AI::HeroesAction( *this, tileIndex );
 
@@ -205,6 +205,7 @@ uint32_t HeroBase::GetSpellPoints() const
 void HeroBase::SetSpellPoints( const uint32_t points )
 {
     magic_point = points;
+    GetArmy().InvalidateCachedStrength();
 }
 
 bool HeroBase::HaveSpellPoints( const Spell & spell ) const
@@ -239,8 +240,10 @@ bool HeroBase::HaveSpell( const Spell & spell, const bool skip_bag ) const
 
 void HeroBase::AppendSpellToBook( const Spell & spell, const bool without_wisdom )
 {
-    if ( without_wisdom || CanLearnSpell( spell ) )
+    if ( without_wisdom || CanLearnSpell( spell ) ) {
         spell_book.Append( spell );
+        GetArmy().InvalidateCachedStrength();
+    }
 }
 
 void HeroBase::AppendSpellsToBook( const SpellStorage & spells, const bool without_wisdom )
@@ -457,6 +460,8 @@ void HeroBase::SpellCasted( const Spell & spell )
     // move point cost
     if ( spell.MovePoint() )
         move_point -= ( spell.MovePoint() < move_point ? spell.MovePoint() : move_point );
+
+    GetArmy().InvalidateCachedStrength();
 }
 
 bool HeroBase::CanTranscribeScroll( const Artifact & art ) const
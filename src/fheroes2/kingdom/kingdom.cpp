@@ -35,6 +35,7 @@
 #include "game_static.h"
 #include "kingdom.h"
 #include "logging.h"
+#include "maps.h"
 #include "players.h"
 #include "profit.h"
 #include "race.h"
@@ -146,6 +147,9 @@ void Kingdom::LossPostActions( void )
 
 void Kingdom::ActionBeforeTurn()
 {
+    // Armies could have been changed by other players in a way which is not tracked
+    Army::InvalidateStrengthCache();
+
     if ( isControlHuman() ) {
         // Recalculate the existing paths of heroes if the kingdom is controlled by a human
         std::for_each( heroes.begin(), heroes.end(), []( Heroes * hero ) { hero->calculatePath( -1 ); } );
@@ -497,8 +501,19 @@ Puzzle & Kingdom::PuzzleMaps( void )
 
 void Kingdom::SetVisitTravelersTent( int col )
 {
+    if ( IsVisitTravelersTent( col ) ) {
+        return;
+    }
+
     // visited_tents_color is a bitfield
     visited_tents_colors |= ( 1 << col );
+
+    // Barriers of this color become passable for the kingdom
+    for ( const int32_t index : Maps::GetObjectPositions( MP2::OBJ_BARRIER, true ) ) {
+        if ( world.GetTiles( index ).QuantityColor() == col ) {
+            world.updatePathfinder( index, false );
+        }
+    }
 }
 
 bool Kingdom::IsVisitTravelersTent( int col ) const
@@ -28,11 +28,17 @@
 #include "image.h"
 #include "interface_border.h"
 #include "maps.h"
+#include "players.h"
 #include "settings.h"
+#include "thread_pool.h"
+#include "til.h"
 #include "tools.h"
 #include "world.h"
 
+#include <algorithm>
 #include <cassert>
+#include <set>
+#include <vector>
 
 // #define VIEWWORLD_DEBUG_ZOOM_LEVEL // Activate this when you want to debug this window. It will provide an extra zoom level at 1:1 scale
 
@@ -131,26 +137,83 @@ namespace
         }
     }
 
-    struct CacheForMapWithResources
+    // Images are loaded on first use which is not thread-safe. Load everything drawn on the map before rendering it on several threads.
+    void loadMapImages()
     {
-        std::vector<fheroes2::Image> cachedImages; // One image per zoom Level
+        fheroes2::AGG::GetTIL( TIL::GROUND32, 0, 0 );
+        fheroes2::AGG::GetTIL( TIL::STON, 0, 0 );
+        fheroes2::AGG::GetTIL( TIL::CLOF32, 0, 0 );
+
+        // Boats, fog and fading objects are drawn from full sprites, everything else on the map from packed ones
+        const std::vector<int> fullSpriteIcns
+            = { ICN::MINIMON, ICN::BOAT32, ICN::BOATSHAD, ICN::CLOP32, MP2::GetICNObject( Game::ObjectFadeAnimation::GetFadeTask().objectTileset ) };
+        for ( const int icn : fullSpriteIcns ) {
+            if ( icn != ICN::UNKNOWN ) {
+                fheroes2::AGG::GetICN( icn, 0 );
+            }
+        }
 
-        CacheForMapWithResources() = delete;
+        std::set<int> icns = { ICN::MINIMON, ICN::OBJNHAUN, ICN::OBJNXTRA };
 
-        // Compute complete world map, and save it for all zoom levels
-        explicit CacheForMapWithResources( const bool revealAll )
-        {
-#ifdef VIEWWORLD_DEBUG_ZOOM_LEVEL
-            cachedImages.resize( 4 );
-#else
-            cachedImages.resize( 3 );
-#endif
+        for ( int32_t index = 0; index < world.w() * world.h(); ++index ) {
+            const Maps::Tiles & tile = world.GetTiles( index );
 
-            for ( size_t i = 0; i < cachedImages.size(); ++i ) {
-                cachedImages[i].resize( world.w() * tileSizePerZoomLevel[i], world.h() * tileSizePerZoomLevel[i] );
-                cachedImages[i]._disableTransformLayer();
+            icns.insert( MP2::GetICNObject( tile.GetObjectTileset() ) );
+            for ( const Maps::TilesAddon & addon : tile.getLevel1Addons() ) {
+                icns.insert( MP2::GetICNObject( addon.object ) );
             }
+            for ( const Maps::TilesAddon & addon : tile.getLevel2Addons() ) {
+                icns.insert( MP2::GetICNObject( addon.object ) );
+            }
+        }
+
+        for ( const int icn : icns ) {
+            if ( icn != ICN::UNKNOWN ) {
+                fheroes2::AGG::GetPackedICN( icn, 0 );
+            }
+        }
+    }
 
+    // Hash of everything which affects the look of a tile in View World. Animation frames are left out as a single still frame is shown.
+    size_t getTileHash( const Maps::Tiles & tile, const bool revealAll, const int friendColors )
+    {
+        size_t hash = tile.TileSpriteIndex();
+        fheroes2::hashCombine( hash, tile.TileSpriteShape() );
+        fheroes2::hashCombine( hash, static_cast<int>( tile.GetObject( false ) ) );
+        fheroes2::hashCombine( hash, static_cast<int>( tile.GetObject( true ) ) );
+        fheroes2::hashCombine( hash, tile.GetObjectTileset() );
+        fheroes2::hashCombine( hash, tile.GetObjectSpriteIndex() );
+        fheroes2::hashCombine( hash, tile.GetQuantity3() );
+
+        for ( const Maps::TilesAddon & addon : tile.getLevel1Addons() ) {
+            fheroes2::hashCombine( hash, addon.object );
+            fheroes2::hashCombine( hash, addon.index );
+        }
+
+        // Level 2 addons are separated from level 1 ones to tell apart the same sprite moved between levels
+        fheroes2::hashCombine( hash, tile.getLevel1Addons().size() );
+
+        for ( const Maps::TilesAddon & addon : tile.getLevel2Addons() ) {
+            fheroes2::hashCombine( hash, addon.object );
+            fheroes2::hashCombine( hash, addon.index );
+        }
+
+        if ( !revealAll ) {
+            fheroes2::hashCombine( hash, tile.isFog( friendColors ) );
+        }
+
+        return hash;
+    }
+
+    // Complete world map for all zoom levels. It is kept between openings of the View World window and only the blocks of the map with
+    // changed tiles are rendered again.
+    struct CacheForMapWithResources
+    {
+        std::vector<fheroes2::Image> cachedImages; // One image per zoom Level
+        std::vector<size_t> blockHashes;
+
+        void update( const bool revealAll )
+        {
             const int32_t blockSizeX = TILEWIDTH * 18;
             const int32_t blockSizeY = TILEWIDTH * 18;
 
@@ -161,12 +224,59 @@ namespace
             assert( worldWidthPixels % blockSizeX == 0 );
             assert( worldHeightPixels % blockSizeY == 0 );
 
-            // Create temporary image where we will draw blocks of the main map on
-            fheroes2::Image temporaryImg( blockSizeX, blockSizeY );
-            temporaryImg._disableTransformLayer();
+            const int32_t blockCountX = worldWidthPixels / blockSizeX;
+            const int32_t blockCountY = worldHeightPixels / blockSizeY;
+
+            if ( cachedImages.empty() || cachedImages[0].width() != world.w() * tileSizePerZoomLevel[0]
+                 || cachedImages[0].height() != world.h() * tileSizePerZoomLevel[0] ) {
+#ifdef VIEWWORLD_DEBUG_ZOOM_LEVEL
+                cachedImages.resize( 4 );
+#else
+                cachedImages.resize( 3 );
+#endif
+
+                for ( size_t i = 0; i < cachedImages.size(); ++i ) {
+                    cachedImages[i].resize( world.w() * tileSizePerZoomLevel[i], world.h() * tileSizePerZoomLevel[i] );
+                    cachedImages[i]._disableTransformLayer();
+                }
+
+                blockHashes.clear();
+            }
+
+            blockHashes.resize( static_cast<size_t>( blockCountX * blockCountY ), 0 );
+
+            // Blocks are drawn together with the neighbouring tiles so their changes must be seen too
+            const int32_t blockTileMargin = 2;
+            const int friendColors = Players::FriendColors();
 
-            Interface::GameArea gamearea = Interface::Basic::Get().GetGameArea();
-            gamearea.SetAreaPosition( 0, 0, blockSizeX, blockSizeY );
+            std::vector<int32_t> changedBlocks;
+
+            for ( int32_t blockId = 0; blockId < blockCountX * blockCountY; ++blockId ) {
+                const int32_t firstTileX = ( blockId % blockCountX ) * blockSizeX / TILEWIDTH;
+                const int32_t firstTileY = ( blockId / blockCountX ) * blockSizeY / TILEWIDTH;
+
+                const int32_t minX = std::max( firstTileX - blockTileMargin, 0 );
+                const int32_t minY = std::max( firstTileY - blockTileMargin, 0 );
+                const int32_t maxX = std::min( firstTileX + blockSizeX / TILEWIDTH + blockTileMargin, world.w() );
+                const int32_t maxY = std::min( firstTileY + blockSizeY / TILEWIDTH + blockTileMargin, world.h() );
+
+                // Zero hash is reserved for blocks which were never rendered
+                size_t hash = 1;
+                for ( int32_t y = minY; y < maxY; ++y ) {
+                    for ( int32_t x = minX; x < maxX; ++x ) {
+                        fheroes2::hashCombine( hash, getTileHash( world.GetTiles( x, y ), revealAll, friendColors ) );
+                    }
+                }
+
+                if ( blockHashes[blockId] != hash ) {
+                    blockHashes[blockId] = hash;
+                    changedBlocks.emplace_back( blockId );
+                }
+            }
+
+            if ( changedBlocks.empty() ) {
+                return;
+            }
 
             int drawingFlags = Interface::RedrawLevelType::LEVEL_ALL & ~Interface::RedrawLevelType::LEVEL_ROUTES;
             if ( revealAll ) {
@@ -177,9 +287,22 @@ namespace
             drawingFlags ^= Interface::RedrawLevelType::LEVEL_HEROES;
 #endif
 
-            // Draw sub-blocks of the main map, and resize them to draw them on lower-res cached versions:
-            for ( int x = 0; x < worldWidthPixels; x += blockSizeX ) {
-                for ( int y = 0; y < worldHeightPixels; y += blockSizeY ) {
+            const Interface::GameArea & mainGameArea = Interface::Basic::Get().GetGameArea();
+
+            // Draw sub-blocks of the main map, and resize them to draw them on lower-res cached versions.
+            // Every block is written to its own area of the cached images so blocks can be drawn at the same time.
+            const auto renderBlocks = [this, &changedBlocks, &mainGameArea, drawingFlags, blockCountX]( const size_t begin, const size_t end ) {
+                // Create temporary image where we will draw blocks of the main map on
+                fheroes2::Image temporaryImg( blockSizeX, blockSizeY );
+                temporaryImg._disableTransformLayer();
+
+                Interface::GameArea gamearea = mainGameArea;
+                gamearea.SetAreaPosition( 0, 0, blockSizeX, blockSizeY );
+
+                for ( size_t id = begin; id < end; ++id ) {
+                    const int32_t x = ( changedBlocks[id] % blockCountX ) * blockSizeX;
+                    const int32_t y = ( changedBlocks[id] / blockCountX ) * blockSizeY;
+
                     gamearea.SetCenterInPixels( fheroes2::Point( x + blockSizeX / 2, y + blockSizeY / 2 ) );
                     gamearea.Redraw( temporaryImg, drawingFlags );
 
@@ -190,14 +313,33 @@ namespace
                                           y * tileSizePerZoomLevel[i] / TILEWIDTH, blockSizeResizedX, blockSizeResizedY );
                     }
                 }
-            }
+            };
 
 #if defined( SAVE_WORLD_MAP )
+            // Heroes change their state while being drawn so the blocks are drawn one by one
+            renderBlocks( 0, changedBlocks.size() );
+
             fheroes2::Save( cachedImages[3], Settings::Get().MapsName() + saveFilePrefix + ".bmp" );
+#else
+            loadMapImages();
+
+            fheroes2::parallelFor( changedBlocks.size(), renderBlocks );
 #endif
         }
     };
 
+    CacheForMapWithResources & getCacheForMapWithResources( const bool revealAll )
+    {
+        // Separate caches for maps with and without fog
+        static CacheForMapWithResources cacheWithFog;
+        static CacheForMapWithResources cacheWithoutFog;
+
+        CacheForMapWithResources & cache = revealAll ? cacheWithoutFog : cacheWithFog;
+        cache.update( revealAll );
+
+        return cache;
+    }
+
     void DrawWorld( const ViewWorld::ZoomROIs & ROI, CacheForMapWithResources & cache )
     {
         fheroes2::Display & display = fheroes2::Display::instance();
@@ -539,7 +681,7 @@ void ViewWorld::ViewWorldWindow( const int color, const ViewWorldMode mode, Inte
 
     ZoomROIs currentROI( ZoomLevel::ZoomLevel2, viewCenterInPixels );
 
-    CacheForMapWithResources cache( mode == ViewWorldMode::ViewAll );
+    CacheForMapWithResources & cache = getCacheForMapWithResources( mode == ViewWorldMode::ViewAll );
 
     DrawWorld( currentROI, cache );
     DrawObjectsIcons( color, mode, currentROI );
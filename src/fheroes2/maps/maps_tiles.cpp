@@ -63,6 +63,7 @@
 #include "text.h"
 #endif
 #include "til.h"
+#include "tools.h"
 #include "trees.h"
 #include "world.h"
 
@@ -789,8 +790,11 @@ MP2::MapObjectType Maps::Tiles::GetObject( bool ignoreObjectUnderHero /* true */
 
 void Maps::Tiles::SetObject( const MP2::MapObjectType objectType )
 {
+    // Monsters protect the adjacent tiles
+    const bool isProtectionChanged = ( mp2_object == MP2::OBJ_MONSTER ) != ( objectType == MP2::OBJ_MONSTER );
+
     mp2_object = objectType;
-    world.resetPathfinder();
+    world.updatePathfinder( _index, isProtectionChanged );
 }
 
 void Maps::Tiles::setBoat( int direction )
@@ -1250,13 +1254,13 @@ void Maps::Tiles::RedrawAddon( fheroes2::Image & dst, const Addons & addon, cons
         const int icn = MP2::GetICNObject( ( *it ).object );
 
         if ( ICN::UNKNOWN != icn && ICN::MINIHERO != icn && ICN::MONS32 != icn && ( !isPuzzleDraw || !MP2::isHiddenForPuzzle( it->object, index ) ) ) {
-            const fheroes2::Sprite & sprite = fheroes2::AGG::GetICN( icn, index );
+            const fheroes2::PackedSprite & sprite = fheroes2::AGG::GetPackedICN( icn, index );
             area.BlitOnTile( dst, sprite, sprite.x(), sprite.y(), mp );
 
             // possible animation
             const uint32_t animationIndex = ICN::AnimationFrame( icn, index, Game::MapsAnimationFrame(), quantity2 != 0 );
             if ( animationIndex ) {
-                area.BlitOnTile( dst, fheroes2::AGG::GetICN( icn, animationIndex ), mp );
+                area.BlitOnTile( dst, fheroes2::AGG::GetPackedICN( icn, animationIndex ), mp );
             }
         }
     }
@@ -1267,6 +1271,24 @@ void Maps::Tiles::RedrawBottom( fheroes2::Image & dst, const fheroes2::Rect & vi
     RedrawAddon( dst, addons_level1, visibleTileROI, isPuzzleDraw, area );
 }
 
+size_t Maps::Tiles::GetBottomLayerHash() const
+{
+    size_t hash = pack_sprite_index;
+
+    // Only the addons and animation frames which RedrawAddon() would draw outside of the puzzle
+    for ( const TilesAddon & addon : addons_level1 ) {
+        const int icn = MP2::GetICNObject( addon.object );
+
+        if ( ICN::UNKNOWN != icn && ICN::MINIHERO != icn && ICN::MONS32 != icn ) {
+            fheroes2::hashCombine( hash, icn );
+            fheroes2::hashCombine( hash, addon.index );
+            fheroes2::hashCombine( hash, ICN::AnimationFrame( icn, addon.index, Game::MapsAnimationFrame(), quantity2 != 0 ) );
+        }
+    }
+
+    return hash;
+}
+
 void Maps::Tiles::RedrawPassable( fheroes2::Image & dst, const fheroes2::Rect & visibleTileROI, const Interface::GameArea & area ) const
 {
 #ifdef WITH_DEBUG
@@ -1294,13 +1316,13 @@ void Maps::Tiles::RedrawObjects( fheroes2::Image & dst, bool isPuzzleDraw, const
         if ( ICN::UNKNOWN != icn ) {
             const fheroes2::Point & mp = Maps::GetPoint( _index );
 
-            const fheroes2::Sprite & sprite = fheroes2::AGG::GetICN( icn, objectIndex );
+            const fheroes2::PackedSprite & sprite = fheroes2::AGG::GetPackedICN( icn, objectIndex );
             area.BlitOnTile( dst, sprite, sprite.x(), sprite.y(), mp );
 
             // possible animation
             const uint32_t animationIndex = ICN::AnimationFrame( icn, objectIndex, Game::MapsAnimationFrame(), quantity2 != 0 );
             if ( animationIndex ) {
-                const fheroes2::Sprite & animationSprite = fheroes2::AGG::GetICN( icn, animationIndex );
+                const fheroes2::PackedSprite & animationSprite = fheroes2::AGG::GetPackedICN( icn, animationIndex );
 
                 area.BlitOnTile( dst, animationSprite, mp );
             }
@@ -1318,11 +1340,11 @@ void Maps::Tiles::RedrawMonster( fheroes2::Image & dst, const fheroes2::Rect & v
     const Monster & monster = QuantityMonster();
     const std::pair<uint32_t, uint32_t> spriteIndicies = GetMonsterSpriteIndices( *this, monster.GetSpriteIndex() );
 
-    const fheroes2::Sprite & sprite = fheroes2::AGG::GetICN( ICN::MINIMON, spriteIndicies.first );
+    const fheroes2::PackedSprite & sprite = fheroes2::AGG::GetPackedICN( ICN::MINIMON, spriteIndicies.first );
     area.BlitOnTile( dst, sprite, sprite.x() + 16, sprite.y() + 30, mp );
 
     if ( spriteIndicies.second ) {
-        const fheroes2::Sprite & animatedSprite = fheroes2::AGG::GetICN( ICN::MINIMON, spriteIndicies.second );
+        const fheroes2::PackedSprite & animatedSprite = fheroes2::AGG::GetPackedICN( ICN::MINIMON, spriteIndicies.second );
         area.BlitOnTile( dst, animatedSprite, animatedSprite.x() + 16, animatedSprite.y() + 30, mp );
     }
 }
@@ -1420,11 +1442,11 @@ void Maps::Tiles::RedrawBottom4Hero( fheroes2::Image & dst, const fheroes2::Rect
         if ( !Interface::SkipRedrawTileBottom4Hero( object, index, tilePassable ) ) {
             const int icn = MP2::GetICNObject( object );
 
-            area.BlitOnTile( dst, fheroes2::AGG::GetICN( icn, index ), mp );
+            area.BlitOnTile( dst, fheroes2::AGG::GetPackedICN( icn, index ), mp );
 
             // possible anime
             if ( it->object & 1 ) {
-                area.BlitOnTile( dst, fheroes2::AGG::GetICN( icn, ICN::AnimationFrame( icn, index, Game::MapsAnimationFrame(), quantity2 != 0 ) ), mp );
+                area.BlitOnTile( dst, fheroes2::AGG::GetPackedICN( icn, ICN::AnimationFrame( icn, index, Game::MapsAnimationFrame(), quantity2 != 0 ) ), mp );
             }
         }
     }
@@ -1440,15 +1462,15 @@ void Maps::Tiles::RedrawTop( fheroes2::Image & dst, const fheroes2::Rect & visib
     const MP2::MapObjectType objectType = GetObject( false );
     // animate objects
     if ( objectType == MP2::OBJ_ABANDONEDMINE ) {
-        area.BlitOnTile( dst, fheroes2::AGG::GetICN( ICN::OBJNHAUN, Game::MapsAnimationFrame() % 15 ), mp );
+        area.BlitOnTile( dst, fheroes2::AGG::GetPackedICN( ICN::OBJNHAUN, Game::MapsAnimationFrame() % 15 ), mp );
     }
     else if ( objectType == MP2::OBJ_MINES ) {
         const uint8_t spellID = quantity3;
         if ( spellID == Spell::HAUNT ) {
-            area.BlitOnTile( dst, fheroes2::AGG::GetICN( ICN::OBJNHAUN, Game::MapsAnimationFrame() % 15 ), mp );
+            area.BlitOnTile( dst, fheroes2::AGG::GetPackedICN( ICN::OBJNHAUN, Game::MapsAnimationFrame() % 15 ), mp );
         }
         else if ( spellID >= Spell::SETEGUARDIAN && spellID <= Spell::SETWGUARDIAN ) {
-            area.BlitOnTile( dst, fheroes2::AGG::GetICN( ICN::OBJNXTRA, spellID - Spell::SETEGUARDIAN ), TILEWIDTH, 0, mp );
+            area.BlitOnTile( dst, fheroes2::AGG::GetPackedICN( ICN::OBJNXTRA, spellID - Spell::SETEGUARDIAN ), TILEWIDTH, 0, mp );
         }
     }
 
@@ -1465,7 +1487,7 @@ void Maps::Tiles::RedrawTopFromBottom( fheroes2::Image & dst, const Interface::G
     for ( const Maps::TilesAddon & addon : tile.addons_level2 ) {
         const int icn = MP2::GetICNObject( addon.object );
         if ( icn == ICN::FLAG32 ) {
-            area.BlitOnTile( dst, fheroes2::AGG::GetICN( icn, addon.index ), mp );
+            area.BlitOnTile( dst, fheroes2::AGG::GetPackedICN( icn, addon.index ), mp );
         }
     }
 }
@@ -1484,11 +1506,11 @@ void Maps::Tiles::RedrawTop4Hero( fheroes2::Image & dst, const fheroes2::Rect &
             const int icn = MP2::GetICNObject( object );
 
             if ( ICN::HighlyObjectSprite( icn, index ) ) {
-                area.BlitOnTile( dst, fheroes2::AGG::GetICN( icn, index ), mp );
+                area.BlitOnTile( dst, fheroes2::AGG::GetPackedICN( icn, index ), mp );
 
                 // possible anime
                 if ( object & 1 ) {
-                    area.BlitOnTile( dst, fheroes2::AGG::GetICN( icn, ICN::AnimationFrame( icn, index, Game::MapsAnimationFrame() ) ), mp );
+                    area.BlitOnTile( dst, fheroes2::AGG::GetPackedICN( icn, ICN::AnimationFrame( icn, index, Game::MapsAnimationFrame() ) ), mp );
                 }
             }
         }
@@ -1660,6 +1682,7 @@ void Maps::Tiles::SetObjectPassable( bool pass )
             tilePassable |= Direction::TOP_LEFT;
         else
             tilePassable &= ~Direction::TOP_LEFT;
+        world.updatePathfinder( _index, false );
         break;
 
     default:
@@ -2222,7 +2245,14 @@ std::pair<uint32_t, uint32_t> Maps::Tiles::GetMonsterSpriteIndices( const Tiles
 
 void Maps::Tiles::ClearFog( int colors )
 {
+    if ( ( fog_colors & colors ) == 0 ) {
+        return;
+    }
+
     fog_colors &= ~colors;
+
+    // Fogged tiles are impassable for the pathfinders, the revealed tile has to be re-evaluated
+    world.updatePathfinder( _index, false );
 }
 
 bool Maps::Tiles::isFogAllAround( const int color ) const
@@ -20,7 +20,9 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <array>
 #include <cmath>
+#include <vector>
 
 #include "castle.h"
 #include "difficulty.h"
@@ -210,6 +212,69 @@ u32 Monster::GetGrown() const
     return fheroes2::getMonsterData( id ).generalStats.baseGrowth;
 }
 
+namespace
+{
+    // Strength of a monster type without its attack and defense skills
+    double GetMonsterBaseStrength( const Monster & monster )
+    {
+        const fheroes2::MonsterBattleStats & battleStats = fheroes2::getMonsterData( monster.GetID() ).battleStats;
+
+        const double effectiveHP = battleStats.hp * ( monster.ignoreRetaliation() ? 1.4 : 1 );
+
+        double damagePotential = ( battleStats.damageMin + battleStats.damageMax ) / 2.0;
+
+        if ( monster.isTwiceAttack() ) {
+            // Melee attacker will lose potential on second attack after retaliation
+            damagePotential *= ( monster.isArchers() || monster.ignoreRetaliation() ) ? 2 : 1.75;
+        }
+        if ( monster.isAbilityPresent( fheroes2::MonsterAbilityType::DOUBLE_DAMAGE_TO_UNDEAD ) )
+            damagePotential *= 1.15; // 15% of all Monsters are Undead, deals double dmg
+        if ( monster.isDoubleCellAttack() )
+            damagePotential *= 1.2;
+        if ( monster.isAbilityPresent( fheroes2::MonsterAbilityType::ALWAYS_RETALIATE ) )
+            damagePotential *= 1.25;
+        if ( monster.isAbilityPresent( fheroes2::MonsterAbilityType::ALL_ADJACENT_CELL_MELEE_ATTACK ) || monster.isAbilityPresent( fheroes2::MonsterAbilityType::AREA_SHOT ) )
+            damagePotential *= 1.3;
+
+        double monsterSpecial = 1.0;
+        if ( monster.isArchers() ) {
+            monsterSpecial += monster.isAbilityPresent( fheroes2::MonsterAbilityType::NO_MELEE_PENALTY ) ? 0.5 : 0.4;
+        }
+        if ( monster.isFlying() ) {
+            monsterSpecial += 0.3;
+        }
+
+        switch ( monster.GetID() ) {
+        case Monster::UNICORN:
+        case Monster::CYCLOPS:
+        case Monster::MEDUSA:
+            // 20% to Blind, Paralyze and Petrify
+            monsterSpecial += 0.2;
+            break;
+        case Monster::VAMPIRE_LORD:
+            // Lifesteal
+            monsterSpecial += 0.3;
+            break;
+        case Monster::GENIE:
+            // Genie's ability to half enemy troops
+            monsterSpecial += 1;
+            break;
+        case Monster::GHOST:
+            // Ghost's ability to increase the numbers
+            monsterSpecial += 2;
+            break;
+        }
+
+        // Higher speed gives initiative advantage/first attack. Remap speed value to -0.2...+0.15, AVERAGE is 0
+        // Punish slow speeds more as unit won't participate in first rounds and slows down strategic army
+        const int speedDiff = battleStats.speed - Speed::AVERAGE;
+        monsterSpecial += ( speedDiff < 0 ) ? speedDiff * 0.1 : speedDiff * 0.05;
+
+        // Additonal HP and Damage effectiveness diminishes with every combat round; strictly x4 HP == x2 unit count
+        return sqrt( damagePotential * effectiveHP ) * monsterSpecial;
+    }
+}
+
 // Get universal heuristic of Monster type regardless of context; both combat and strategic value
 // Doesn't account for situational special bonuses such as spell immunity
 double Monster::GetMonsterStrength( int attack, int defense ) const
@@ -225,59 +290,21 @@ double Monster::GetMonsterStrength( int attack, int defense ) const
         defense = battleStats.defense;
 
     const double attackDefense = 1.0 + attack * 0.1 + defense * 0.05;
-    const double effectiveHP = battleStats.hp * ( ignoreRetaliation() ? 1.4 : 1 );
-
-    double damagePotential = ( battleStats.damageMin + battleStats.damageMax ) / 2.0;
-
-    if ( isTwiceAttack() ) {
-        // Melee attacker will lose potential on second attack after retaliation
-        damagePotential *= ( isArchers() || ignoreRetaliation() ) ? 2 : 1.75;
-    }
-    if ( isAbilityPresent( fheroes2::MonsterAbilityType::DOUBLE_DAMAGE_TO_UNDEAD ) )
-        damagePotential *= 1.15; // 15% of all Monsters are Undead, deals double dmg
-    if ( isDoubleCellAttack() )
-        damagePotential *= 1.2;
-    if ( isAbilityPresent( fheroes2::MonsterAbilityType::ALWAYS_RETALIATE ) )
-        damagePotential *= 1.25;
-    if ( isAbilityPresent( fheroes2::MonsterAbilityType::ALL_ADJACENT_CELL_MELEE_ATTACK ) || isAbilityPresent( fheroes2::MonsterAbilityType::AREA_SHOT ) )
-        damagePotential *= 1.3;
-
-    double monsterSpecial = 1.0;
-    if ( isArchers() ) {
-        monsterSpecial += isAbilityPresent( fheroes2::MonsterAbilityType::NO_MELEE_PENALTY ) ? 0.5 : 0.4;
-    }
-    if ( isFlying() ) {
-        monsterSpecial += 0.3;
-    }
 
-    switch ( id ) {
-    case Monster::UNICORN:
-    case Monster::CYCLOPS:
-    case Monster::MEDUSA:
-        // 20% to Blind, Paralyze and Petrify
-        monsterSpecial += 0.2;
-        break;
-    case Monster::VAMPIRE_LORD:
-        // Lifesteal
-        monsterSpecial += 0.3;
-        break;
-    case Monster::GENIE:
-        // Genie's ability to half enemy troops
-        monsterSpecial += 1;
-        break;
-    case Monster::GHOST:
-        // Ghost's ability to increase the numbers
-        monsterSpecial += 2;
-        break;
-    }
+    // Everything except attack and defense depends only on the monster type so it is computed once per type. The table can't be built at
+    // compile time: monster stats and abilities are filled in at runtime by fheroes2::getMonsterData().
+    static const std::array<double, Monster::WATER_ELEMENT + 1> baseStrength = []() {
+        std::array<double, Monster::WATER_ELEMENT + 1> values{};
+        for ( int monsterId = Monster::UNKNOWN; monsterId <= Monster::WATER_ELEMENT; ++monsterId ) {
+            values[monsterId] = GetMonsterBaseStrength( Monster( monsterId ) );
+        }
+        return values;
+    }();
 
-    // Higher speed gives initiative advantage/first attack. Remap speed value to -0.2...+0.15, AVERAGE is 0
-    // Punish slow speeds more as unit won't participate in first rounds and slows down strategic army
-    const int speedDiff = battleStats.speed - Speed::AVERAGE;
-    monsterSpecial += ( speedDiff < 0 ) ? speedDiff * 0.1 : speedDiff * 0.05;
+    if ( id >= Monster::UNKNOWN && id <= Monster::WATER_ELEMENT )
+        return baseStrength[id] * attackDefense;
 
-    // Additonal HP and Damage effectiveness diminishes with every combat round; strictly x4 HP == x2 unit count
-    return sqrt( damagePotential * effectiveHP ) * attackDefense * monsterSpecial;
+    return GetMonsterBaseStrength( *this ) * attackDefense;
 }
 
 u32 Monster::GetRNDSize( bool skip_factor ) const
@@ -27,6 +27,7 @@
 #include <vector>
 
 #include "agg_image.h"
+#include "army.h"
 #include "artifact.h"
 #include "dialog.h"
 #include "dialog_selectitems.h"
@@ -686,6 +687,8 @@ bool BagArtifacts::PushArtifact( const Artifact & art )
         if ( art.GetID() == Artifact::MAGIC_BOOK )
             std::swap( *it, front() );
 
+        Army::InvalidateStrengthCache();
+
         return true;
     }
 
@@ -695,8 +698,10 @@ bool BagArtifacts::PushArtifact( const Artifact & art )
 void BagArtifacts::RemoveArtifact( const Artifact & art )
 {
     iterator it = std::find( begin(), end(), art );
-    if ( it != end() )
+    if ( it != end() ) {
         ( *it ).Reset();
+        Army::InvalidateStrengthCache();
+    }
 }
 
 bool BagArtifacts::isFull( void ) const
@@ -761,8 +766,10 @@ void BagArtifacts::RemoveScroll( const Artifact & art )
     Spell spell( art.GetSpell() );
     if ( spell.isValid() ) {
         iterator it = std::find( begin(), end(), spell );
-        if ( it != end() )
+        if ( it != end() ) {
             ( *it ).Reset();
+            Army::InvalidateStrengthCache();
+        }
     }
 }
 
@@ -1009,6 +1009,8 @@ std::string Settings::ExtName( const uint32_t settingId )
         return _( "battle: reverse wait order (fast, average, slow)" );
     case Settings::BATTLE_DETERMINISTIC_RESULT:
         return _( "battle: deterministic events" );
+    case Settings::BATTLE_AI_LOOKAHEAD:
+        return _( "battle: AI looks a few moves ahead (slower)" );
     case Settings::GAME_SHOW_SYSTEM_INFO:
         return _( "game: show system info" );
     case Settings::GAME_AUTOSAVE_BEGIN_DAY:
@@ -1180,6 +1182,11 @@ bool Settings::ExtBattleReverseWaitOrder() const
     return ExtModes( BATTLE_REVERSE_WAIT_ORDER );
 }
 
+bool Settings::ExtBattleAILookahead() const
+{
+    return ExtModes( BATTLE_AI_LOOKAHEAD );
+}
+
 bool Settings::ExtWorldNeutralArmyDifficultyScaling() const
 {
     return ExtModes( WORLD_SCALE_NEUTRAL_ARMIES );
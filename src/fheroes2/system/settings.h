@@ -96,7 +96,7 @@ public:
         WORLD_EXT_OBJECTS_CAPTURED = 0x30004000,
         // UNUSED = 0x30008000,
 
-        // UNUSED = 0x40004000,
+        BATTLE_AI_LOOKAHEAD = 0x40004000,
         BATTLE_DETERMINISTIC_RESULT = 0x40008000,
         BATTLE_SOFT_WAITING = 0x40010000,
         BATTLE_REVERSE_WAIT_ORDER = 0x40020000
@@ -191,6 +191,7 @@ public:
     bool ExtBattleSoftWait() const;
     bool ExtBattleDeterministicResult() const;
     bool ExtBattleReverseWaitOrder() const;
+    bool ExtBattleAILookahead() const;
     bool ExtGameRememberLastFocus() const;
     bool ExtGameContinueAfterVictory() const;
     bool ExtGameRewriteConfirm() const;
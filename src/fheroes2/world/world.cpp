@@ -614,6 +614,9 @@ void World::NewDay( void )
 {
     ++day;
 
+    // Morale, luck and other day-dependent bonuses may change
+    Army::InvalidateStrengthCache();
+
     if ( BeginWeek() ) {
         ++week;
 
@@ -1240,7 +1243,7 @@ uint32_t World::getDistance( const Heroes & hero, int targetIndex )
 
 std::list<Route::Step> World::getPath( const Heroes & hero, int targetIndex )
 {
-    _pathfinder.reEvaluateIfNeeded( hero );
+    _pathfinder.reEvaluateIfNeeded( hero, targetIndex );
     return _pathfinder.buildPath( targetIndex );
 }
 
@@ -1250,6 +1253,12 @@ void World::resetPathfinder()
     AI::Get().resetPathfinder();
 }
 
+void World::updatePathfinder( const int32_t changedTileIndex, const bool isProtectionChanged )
+{
+    _pathfinder.invalidateTile( changedTileIndex, isProtectionChanged );
+    AI::Get().updatePathfinder( changedTileIndex, isProtectionChanged );
+}
+
 void World::PostLoad( const bool setTilePassabilities )
 {
     if ( setTilePassabilities ) {
@@ -274,9 +274,15 @@ public:
     const MapRegion & getRegion( size_t id ) const;
     size_t getRegionCount() const;
 
+    // Estimates the movement cost between two tiles using the region graph: only the regions of these tiles are searched tile by tile.
+    // The estimate takes only the terrain into account and might include detours through the region portals. Returns 0 if the tiles
+    // are not connected.
+    uint32_t getDistanceEstimate( const int32_t from, const int32_t to ) const;
+
     uint32_t getDistance( const Heroes & hero, int targetIndex );
     std::list<Route::Step> getPath( const Heroes & hero, int targetIndex );
     void resetPathfinder();
+    void updatePathfinder( const int32_t changedTileIndex, const bool isProtectionChanged );
 
     void ComputeStaticAnalysis();
     static u32 GetUniq( void );
@@ -333,7 +339,13 @@ private:
     std::map<uint8_t, Maps::Indexes> _allWhirlpools; // All indexes of tiles that contain a certain part (sprite index) of the whirlpool
 
     std::vector<MapRegion> _regions;
+    std::vector<RegionPortal> _regionPortals;
     PlayerWorldPathfinder _pathfinder;
+
+    // Scratch buffers of getDistanceEstimate() reused between the calls, so they are not thread-safe
+    mutable std::vector<uint32_t> _distanceEstimateCosts;
+    mutable std::vector<int> _distanceEstimateVisited;
+    mutable std::vector<uint32_t> _distanceEstimatePortalCosts;
 };
 
 StreamBase & operator<<( StreamBase &, const CapturedObject & );
@@ -18,8 +18,11 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <cmath>
+#include <functional>
 #include <set>
 #include <tuple>
 
@@ -212,7 +215,27 @@ uint32_t WorldPathfinder::substractMovePoints( const uint32_t movePoints, const
     return movePoints - substractedMovePoints;
 }
 
-void WorldPathfinder::processWorldMap()
+void WorldPathfinder::invalidateTile( const int tileIndex, const bool isProtectionChanged )
+{
+    // Nothing has been evaluated yet
+    if ( _pathStart == -1 ) {
+        return;
+    }
+
+    _changedTiles.push_back( tileIndex );
+
+    if ( isProtectionChanged ) {
+        const Directions & directions = Direction::All();
+
+        for ( size_t i = 0; i < directions.size(); ++i ) {
+            if ( Maps::isValidDirection( tileIndex, directions[i] ) ) {
+                _changedTiles.push_back( tileIndex + _mapOffset[i] );
+            }
+        }
+    }
+}
+
+void WorldPathfinder::processWorldMap( const int targetIndex, const uint32_t distanceLimit )
 {
     // reset cache back to default value
     for ( size_t idx = 0; idx < _cache.size(); ++idx ) {
@@ -220,14 +243,236 @@ void WorldPathfinder::processWorldMap()
     }
     _cache[_pathStart] = WorldNode( -1, 0, MP2::MapObjectType::OBJ_ZERO, _remainingMovePoints );
 
+    _changedTiles.clear();
+    _openNodes.clear();
+
+    pushOpenNode( _pathStart, targetIndex );
+    processOpenNodes( targetIndex, distanceLimit );
+}
+
+bool WorldPathfinder::repairWorldMap( const int newStart, const uint32_t newRemainingMovePoints )
+{
+    if ( _pathStart == -1 || !isSearchComplete() ) {
+        return false;
+    }
+
+    const bool isStartMoved = newStart != _pathStart || newRemainingMovePoints != _remainingMovePoints;
+
+    if ( isStartMoved ) {
+        const WorldNode & newStartNode = _cache[newStart];
+
+        // Existing paths can be reused only if the new starting point has been reached along them with the same remaining movement points
+        if ( newStart == _pathStart || newStartNode._from == -1 || newStartNode._remainingMovePoints != newRemainingMovePoints ) {
+            return false;
+        }
+
+        // Passability rules depend on whether the path starts on water or not
+        if ( world.GetTiles( newStart ).isWater() != world.GetTiles( _pathStart ).isWater() ) {
+            return false;
+        }
+    }
+    else if ( _changedTiles.empty() ) {
+        return true;
+    }
+
+    enum class NodeState : uint8_t
+    {
+        UNKNOWN,
+        IN_PROGRESS,
+        VALID,
+        INVALID,
+        QUEUED
+    };
+
+    std::vector<NodeState> states( _cache.size(), NodeState::UNKNOWN );
+
+    for ( const int idx : _changedTiles ) {
+        states[idx] = NodeState::INVALID;
+    }
+
+    // The starting point always stays valid, but teleports can't be used from it so such moves have to be discarded
+    states[newStart] = NodeState::VALID;
+
+    if ( isStartMoved ) {
+        MapsIndexes teleports = world.GetTeleportEndPoints( newStart );
+        if ( teleports.empty() ) {
+            teleports = world.GetWhirlpoolEndPoints( newStart );
+        }
+
+        for ( const int teleportIdx : teleports ) {
+            if ( _cache[teleportIdx]._from == newStart ) {
+                states[teleportIdx] = NodeState::INVALID;
+            }
+        }
+    }
+
+    // A node stays valid only if its path goes from the new starting point and doesn't pass through any changed tile
+    std::vector<int> pathNodes;
+
+    for ( size_t idx = 0; idx < _cache.size(); ++idx ) {
+        if ( states[idx] != NodeState::UNKNOWN ) {
+            continue;
+        }
+
+        // Unreachable tile, there is nothing to repair here
+        if ( _cache[idx]._from == -1 && static_cast<int>( idx ) != _pathStart ) {
+            states[idx] = NodeState::VALID;
+            continue;
+        }
+
+        NodeState result = NodeState::INVALID;
+
+        int currentNode = static_cast<int>( idx );
+        while ( currentNode != -1 ) {
+            const NodeState state = states[currentNode];
+
+            if ( state == NodeState::VALID || state == NodeState::INVALID ) {
+                result = state;
+                break;
+            }
+
+            // Circular path, the result is unreliable anyway
+            if ( state == NodeState::IN_PROGRESS ) {
+                break;
+            }
+
+            states[currentNode] = NodeState::IN_PROGRESS;
+            pathNodes.push_back( currentNode );
+
+            currentNode = _cache[currentNode]._from;
+        }
+
+        // Paths ending at the previous starting point (or anywhere else) are invalid
+        for ( const int nodeIdx : pathNodes ) {
+            states[nodeIdx] = result;
+        }
+        pathNodes.clear();
+    }
+
+    const uint32_t newStartCost = _cache[newStart]._cost;
+
+    for ( size_t idx = 0; idx < _cache.size(); ++idx ) {
+        WorldNode & node = _cache[idx];
+
+        if ( states[idx] == NodeState::INVALID ) {
+            node.resetNode();
+        }
+        else if ( node._from != -1 ) {
+            assert( node._cost >= newStartCost );
+
+            node._cost -= newStartCost;
+        }
+    }
+
+    _pathStart = newStart;
+    _remainingMovePoints = newRemainingMovePoints;
+    _changedTiles.clear();
+
+    _cache[_pathStart] = WorldNode( -1, 0, MP2::MapObjectType::OBJ_ZERO, _remainingMovePoints );
+
+    _openNodes.clear();
+
+    pushOpenNode( _pathStart, -1 );
+    states[_pathStart] = NodeState::QUEUED;
+
+    // Invalidated nodes can be reached again only from their valid neighbours (including the other ends of teleports)
+    auto queueIfReachable = [this, &states]( const int index ) {
+        if ( states[index] == NodeState::VALID && _cache[index]._from != -1 ) {
+            pushOpenNode( index, -1 );
+            states[index] = NodeState::QUEUED;
+        }
+    };
+
+    const Directions & directions = Direction::All();
+
+    for ( size_t idx = 0; idx < _cache.size(); ++idx ) {
+        if ( states[idx] != NodeState::INVALID ) {
+            continue;
+        }
+
+        const int currentNodeIdx = static_cast<int>( idx );
+
+        for ( size_t i = 0; i < directions.size(); ++i ) {
+            if ( Maps::isValidDirection( currentNodeIdx, directions[i] ) ) {
+                queueIfReachable( currentNodeIdx + _mapOffset[i] );
+            }
+        }
+
+        MapsIndexes teleports = world.GetTeleportEndPoints( currentNodeIdx );
+        if ( teleports.empty() ) {
+            teleports = world.GetWhirlpoolEndPoints( currentNodeIdx );
+        }
+
+        for ( const int teleportIdx : teleports ) {
+            queueIfReachable( teleportIdx );
+        }
+    }
+
+    processOpenNodes( -1, 0 );
+
+    return true;
+}
+
+void WorldPathfinder::pushOpenNode( const int index, const int targetIndex )
+{
+    const uint32_t cost = _cache[index]._cost;
+    const uint32_t priority = targetIndex != -1 ? cost + getHeuristic( index, targetIndex ) : cost;
+
+    _openNodes.push_back( { priority, cost, index } );
+    std::push_heap( _openNodes.begin(), _openNodes.end(), std::greater<OpenNode>() );
+}
+
+void WorldPathfinder::processOpenNodes( const int targetIndex, const uint32_t distanceLimit )
+{
+    _searchTarget = -1;
+    _searchDistanceLimit = 0;
+
     std::vector<int> nodesToExplore;
-    nodesToExplore.push_back( _pathStart );
 
-    for ( size_t lastProcessedNode = 0; lastProcessedNode < nodesToExplore.size(); ++lastProcessedNode ) {
-        processCurrentNode( nodesToExplore, nodesToExplore[lastProcessedNode] );
+    while ( !_openNodes.empty() ) {
+        std::pop_heap( _openNodes.begin(), _openNodes.end(), std::greater<OpenNode>() );
+        const OpenNode current = _openNodes.back();
+        _openNodes.pop_back();
+
+        const WorldNode & currentNode = _cache[current.index];
+
+        // The node has been updated after it was queued, this entry is outdated
+        if ( current.index != _pathStart && ( currentNode._from == -1 || currentNode._cost != current.cost ) ) {
+            continue;
+        }
+
+        // All the remaining nodes are farther than the limit
+        if ( distanceLimit > 0 && current.cost > distanceLimit ) {
+            _searchDistanceLimit = distanceLimit;
+            break;
+        }
+
+        processCurrentNode( nodesToExplore, current.index );
+
+        for ( const int nodeIdx : nodesToExplore ) {
+            pushOpenNode( nodeIdx, targetIndex );
+        }
+        nodesToExplore.clear();
+
+        // Nodes are processed in the order of their costs, so the path to the target can't be improved anymore
+        if ( current.index == targetIndex ) {
+            _searchTarget = _openNodes.empty() ? -1 : targetIndex;
+            break;
+        }
     }
 }
 
+uint32_t WorldPathfinder::getHeuristic( const int from, const int to ) const
+{
+    const int width = world.w();
+
+    const uint32_t distanceX = static_cast<uint32_t>( std::abs( from % width - to % width ) );
+    const uint32_t distanceY = static_cast<uint32_t>( std::abs( from / width - to / width ) );
+
+    // Every move (including the diagonal one) to an adjacent tile costs at least as much as the move along the road
+    return std::max( distanceX, distanceY ) * Maps::Ground::roadPenalty;
+}
+
 void WorldPathfinder::checkAdjacentNodes( std::vector<int> & nodesToExplore, int currentNodeIdx )
 {
     const Directions & directions = Direction::All();
@@ -270,20 +515,58 @@ void PlayerWorldPathfinder::reset()
         _currentColor = Color::NONE;
         _remainingMovePoints = 0;
         _maxMovePoints = 0;
+
+        _searchTarget = -1;
+        _searchDistanceLimit = 0;
+        _changedTiles.clear();
     }
 }
 
 void PlayerWorldPathfinder::reEvaluateIfNeeded( const Heroes & hero )
 {
-    auto currentSettings = std::forward_as_tuple( _pathStart, _pathfindingSkill, _currentColor, _remainingMovePoints, _maxMovePoints );
-    const auto newSettings = std::make_tuple( hero.GetIndex(), static_cast<uint8_t>( hero.GetLevelSkill( Skill::Secondary::PATHFINDING ) ), hero.GetColor(),
-                                              hero.GetMovePoints(), hero.GetMaxMovePoints() );
+    const int start = hero.GetIndex();
+    const uint32_t remainingMovePoints = hero.GetMovePoints();
+
+    auto currentSettings = std::forward_as_tuple( _pathfindingSkill, _currentColor, _maxMovePoints );
+    const auto newSettings = std::make_tuple( static_cast<uint8_t>( hero.GetLevelSkill( Skill::Secondary::PATHFINDING ) ), hero.GetColor(), hero.GetMaxMovePoints() );
+
+    // Try to repair the existing results if only the hero's position or the remaining movement points have changed
+    if ( currentSettings == newSettings && repairWorldMap( start, remainingMovePoints ) ) {
+        return;
+    }
+
+    currentSettings = newSettings;
+    _pathStart = start;
+    _remainingMovePoints = remainingMovePoints;
+
+    processWorldMap();
+}
+
+void PlayerWorldPathfinder::reEvaluateIfNeeded( const Heroes & hero, const int targetIndex )
+{
+    const int start = hero.GetIndex();
+    const uint32_t remainingMovePoints = hero.GetMovePoints();
+
+    auto currentSettings = std::forward_as_tuple( _pathfindingSkill, _currentColor, _maxMovePoints );
+    const auto newSettings = std::make_tuple( static_cast<uint8_t>( hero.GetLevelSkill( Skill::Secondary::PATHFINDING ) ), hero.GetColor(), hero.GetMaxMovePoints() );
 
-    if ( currentSettings != newSettings ) {
-        currentSettings = newSettings;
+    if ( currentSettings == newSettings ) {
+        // Results for the whole map can be repaired
+        if ( repairWorldMap( start, remainingMovePoints ) ) {
+            return;
+        }
 
-        processWorldMap();
+        // Results of the goal-directed search are still valid only for the same target
+        if ( _searchTarget == targetIndex && _pathStart == start && _remainingMovePoints == remainingMovePoints && _changedTiles.empty() ) {
+            return;
+        }
     }
+
+    currentSettings = newSettings;
+    _pathStart = start;
+    _remainingMovePoints = remainingMovePoints;
+
+    processWorldMap( targetIndex );
 }
 
 std::list<Route::Step> PlayerWorldPathfinder::buildPath( int targetIndex ) const
@@ -364,32 +647,48 @@ void AIWorldPathfinder::reset()
         _maxMovePoints = 0;
 
         _armyStrength = -1;
+
+        _searchTarget = -1;
+        _searchDistanceLimit = 0;
+        _changedTiles.clear();
     }
 }
 
 void AIWorldPathfinder::reEvaluateIfNeeded( const Heroes & hero )
 {
-    auto currentSettings = std::forward_as_tuple( _pathStart, _pathfindingSkill, _currentColor, _remainingMovePoints, _maxMovePoints, _armyStrength );
-    const auto newSettings = std::make_tuple( hero.GetIndex(), static_cast<uint8_t>( hero.GetLevelSkill( Skill::Secondary::PATHFINDING ) ), hero.GetColor(),
-                                              hero.GetMovePoints(), hero.GetMaxMovePoints(), hero.GetArmy().GetStrength() );
+    const int start = hero.GetIndex();
+    const uint32_t remainingMovePoints = hero.GetMovePoints();
 
-    if ( currentSettings != newSettings ) {
-        currentSettings = newSettings;
+    auto currentSettings = std::forward_as_tuple( _pathfindingSkill, _currentColor, _maxMovePoints, _armyStrength );
+    const auto newSettings = std::make_tuple( static_cast<uint8_t>( hero.GetLevelSkill( Skill::Secondary::PATHFINDING ) ), hero.GetColor(), hero.GetMaxMovePoints(),
+                                              hero.GetArmy().GetStrength() );
 
-        processWorldMap();
+    // Try to repair the existing results if only the hero's position or the remaining movement points have changed
+    if ( currentSettings == newSettings && repairWorldMap( start, remainingMovePoints ) ) {
+        return;
     }
+
+    currentSettings = newSettings;
+    _pathStart = start;
+    _remainingMovePoints = remainingMovePoints;
+
+    processWorldMap();
 }
 
 void AIWorldPathfinder::reEvaluateIfNeeded( const int start, const int color, const double armyStrength, const uint8_t skill )
 {
-    auto currentSettings = std::forward_as_tuple( _pathStart, _pathfindingSkill, _currentColor, _remainingMovePoints, _maxMovePoints, _armyStrength );
-    const auto newSettings = std::make_tuple( start, skill, color, 0U, 0U, armyStrength );
-
-    if ( currentSettings != newSettings ) {
-        currentSettings = newSettings;
+    auto currentSettings = std::forward_as_tuple( _pathfindingSkill, _currentColor, _maxMovePoints, _armyStrength );
+    const auto newSettings = std::make_tuple( skill, color, 0U, armyStrength );
 
-        processWorldMap();
+    if ( currentSettings == newSettings && repairWorldMap( start, 0 ) ) {
+        return;
     }
+
+    currentSettings = newSettings;
+    _pathStart = start;
+    _remainingMovePoints = 0;
+
+    processWorldMap();
 }
 
 // Overwrites base version in WorldPathfinder, using custom node passability rules
@@ -636,7 +935,7 @@ bool AIWorldPathfinder::isHeroPossiblyBlockingWay( const Heroes & hero )
     return world.GetTiles( start ).GetObject( false ) == MP2::OBJ_STONELITHS;
 }
 
-std::vector<IndexObject> AIWorldPathfinder::getObjectsOnTheWay( int targetIndex, bool checkAdjacent )
+std::vector<IndexObject> AIWorldPathfinder::getObjectsOnTheWay( int targetIndex, bool checkAdjacent ) const
 {
     std::vector<IndexObject> result;
     // validate that path can be created
@@ -690,6 +989,73 @@ std::vector<IndexObject> AIWorldPathfinder::getObjectsOnTheWay( int targetIndex,
     return result;
 }
 
+std::vector<double> AIWorldPathfinder::getObjectsOnTheWayValue( const std::function<double( const IndexObject & )> & objectValue ) const
+{
+    const size_t size = _cache.size();
+
+    // Sum of object values from the start up to the tile including it.
+    std::vector<double> pathValue( size, 0 );
+    std::vector<double> result( size, 0 );
+
+    if ( _pathStart == -1 || _currentColor == Color::NONE )
+        return result;
+
+    const Kingdom & kingdom = world.GetKingdom( _currentColor );
+
+    enum : uint8_t
+    {
+        NOT_VISITED,
+        IN_PROGRESS,
+        DONE
+    };
+
+    std::vector<uint8_t> state( size, NOT_VISITED );
+    state[_pathStart] = DONE;
+
+    std::vector<int> chain;
+
+    for ( size_t index = 0; index < size; ++index ) {
+        if ( state[index] != NOT_VISITED || _cache[index]._cost == 0 )
+            continue;
+
+        // Walk back until we meet a tile with a known value and then fill the whole chain in reverse order.
+        int currentNode = static_cast<int>( index );
+        while ( currentNode != -1 && state[currentNode] == NOT_VISITED ) {
+            state[currentNode] = IN_PROGRESS;
+            chain.push_back( currentNode );
+            currentNode = _cache[currentNode]._from;
+        }
+
+        double value = 0;
+        if ( currentNode != -1 ) {
+            if ( state[currentNode] == IN_PROGRESS ) {
+                DEBUG_LOG( DBG_GAME, DBG_WARN, "Circular path found! " << currentNode );
+            }
+            else {
+                value = pathValue[currentNode];
+            }
+        }
+
+        for ( auto it = chain.rbegin(); it != chain.rend(); ++it ) {
+            const int node = *it;
+            const WorldNode & worldNode = _cache[node];
+
+            result[node] = value;
+
+            if ( worldNode._objectID != MP2::OBJ_ZERO && kingdom.isValidKingdomObject( world.GetTiles( node ), worldNode._objectID ) ) {
+                value += objectValue( IndexObject( node, worldNode._objectID ) );
+            }
+
+            pathValue[node] = value;
+            state[node] = DONE;
+        }
+
+        chain.clear();
+    }
+
+    return result;
+}
+
 std::list<Route::Step> AIWorldPathfinder::buildPath( int targetIndex, bool isPlanningMode ) const
 {
     std::list<Route::Step> path;
@@ -740,6 +1106,32 @@ uint32_t AIWorldPathfinder::getDistance( int start, int targetIndex, int color,
     return _cache[targetIndex]._cost;
 }
 
+void AIWorldPathfinder::evaluateDistanceField( int start, int color, double armyStrength, uint32_t distanceLimit, uint8_t skill )
+{
+    assert( distanceLimit > 0 );
+
+    auto currentSettings = std::forward_as_tuple( _pathfindingSkill, _currentColor, _maxMovePoints, _armyStrength );
+    const auto newSettings = std::make_tuple( skill, color, 0U, armyStrength );
+
+    if ( currentSettings == newSettings ) {
+        // Results for the whole map are suitable as well
+        if ( repairWorldMap( start, 0 ) ) {
+            return;
+        }
+
+        // Results of the previous limited search are still valid if they cover the requested distance
+        if ( _pathStart == start && _searchTarget == -1 && _searchDistanceLimit >= distanceLimit && _changedTiles.empty() ) {
+            return;
+        }
+    }
+
+    currentSettings = newSettings;
+    _pathStart = start;
+    _remainingMovePoints = 0;
+
+    processWorldMap( -1, distanceLimit );
+}
+
 void AIWorldPathfinder::setArmyStrengthMultplier( const double multiplier )
 {
     if ( multiplier > 0 && std::fabs( _advantage - multiplier ) > 0.001 ) {
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "army.h"
 #include "color.h"
 #include "mp2.h"
@@ -57,8 +59,30 @@ public:
     // This method resizes the cache and re-calculates map offsets if values are out of sync with World class
     virtual void checkWorldSize();
 
+    // Marks the tile as changed (an object has appeared or disappeared), so the paths going through it will be repaired on the next
+    // re-evaluation. If the tile has gained or lost a monster, then the passability of the adjacent tiles is affected as well.
+    void invalidateTile( const int tileIndex, const bool isProtectionChanged );
+
 protected:
-    void processWorldMap();
+    // Performs a label-setting (Dijkstra) search over the whole map. If the target index is specified, the search becomes goal-directed (A*)
+    // and stops as soon as the path to the target is final; the cache then contains valid results only for the tiles on this path. The
+    // goal-directed mode relies on the fact that every move costs at least Maps::Ground::roadPenalty, so it must not be used by the rules
+    // which allow to move for free (e.g. through teleports). If the distance limit is specified, the search stops once all the tiles
+    // within this distance are processed; costs of the tiles beyond the limit are either zero or above the limit.
+    void processWorldMap( const int targetIndex = -1, const uint32_t distanceLimit = 0 );
+
+    // Returns true if the cache contains results for the whole map
+    bool isSearchComplete() const
+    {
+        return _searchTarget == -1 && _searchDistanceLimit == 0;
+    }
+
+    // Repairs the results of the previous search for the new starting point and the tiles changed since then, re-evaluating only
+    // the affected part of the search tree (in the spirit of LPA*). The new starting point has to be reached along the existing
+    // paths with the given remaining movement points; the rest of the pathfinding settings must not be changed. Returns false if
+    // the results can't be repaired (or the previous search was not complete) and the whole map has to be re-evaluated.
+    bool repairWorldMap( const int newStart, const uint32_t newRemainingMovePoints );
+
     void checkAdjacentNodes( std::vector<int> & nodesToExplore, int currentNodeIdx );
 
     // This method defines pathfinding rules. This has to be implemented by the derived class.
@@ -78,6 +102,40 @@ protected:
     uint32_t _remainingMovePoints = 0;
     uint32_t _maxMovePoints = 0;
     std::vector<int> _mapOffset;
+
+    // Target of the last goal-directed search or -1 if the search was not stopped at the target
+    int _searchTarget = -1;
+
+    // Distance limit of the last search or 0 if the search was not limited
+    uint32_t _searchDistanceLimit = 0;
+
+    // Tiles changed since the last search
+    std::vector<int> _changedTiles;
+
+private:
+    struct OpenNode
+    {
+        uint32_t priority; // cost of the node plus the estimated cost of the remaining path to the target
+        uint32_t cost;
+        int index;
+
+        // Used to order the min-heap; ties are resolved by the tile index to keep the results independent of the heap implementation
+        bool operator>( const OpenNode & other ) const
+        {
+            return priority > other.priority || ( priority == other.priority && index > other.index );
+        }
+    };
+
+    // Processes queued nodes until the queue is empty, the path to the target (if specified) is final or the distance limit (if specified) is reached
+    void processOpenNodes( const int targetIndex, const uint32_t distanceLimit );
+
+    void pushOpenNode( const int index, const int targetIndex );
+
+    // Returns the lower bound of the movement cost between two tiles
+    uint32_t getHeuristic( const int from, const int to ) const;
+
+    // Binary min-heap of the nodes waiting to be processed, kept between searches to avoid memory reallocations
+    std::vector<OpenNode> _openNodes;
 };
 
 class PlayerWorldPathfinder : public WorldPathfinder
@@ -88,9 +146,14 @@ public:
     void reset() override;
 
     void reEvaluateIfNeeded( const Heroes & hero );
+
+    // Re-evaluates paths only as far as it is needed to build the path to the given target. Use the method above if
+    // distances to other tiles are required as well.
+    void reEvaluateIfNeeded( const Heroes & hero, const int targetIndex );
+
     std::list<Route::Step> buildPath( int targetIndex ) const;
 
-private:
+protected:
     void processCurrentNode( std::vector<int> & nodesToExplore, int currentNodeIdx ) override;
 };
 
@@ -112,11 +175,20 @@ public:
 
     bool isHeroPossiblyBlockingWay( const Heroes & hero );
 
-    std::vector<IndexObject> getObjectsOnTheWay( int targetIndex, bool checkAdjacent = false );
+    std::vector<IndexObject> getObjectsOnTheWay( int targetIndex, bool checkAdjacent = false ) const;
+
+    // Returns the total value of valid objects on the way to every tile in one pass over the current paths, equivalent to summing up the values
+    // of getObjectsOnTheWay( tile ) for each tile separately. The start and the tile itself are not counted, unreachable tiles get 0.
+    std::vector<double> getObjectsOnTheWayValue( const std::function<double( const IndexObject & )> & objectValue ) const;
 
     // Used for non-hero armies, like castles or monsters
     uint32_t getDistance( int start, int targetIndex, int color, double armyStrength, uint8_t skill = Skill::Level::EXPERT );
 
+    // Evaluates distances from the given tile for non-hero armies only up to the given limit, which is much cheaper than the evaluation of
+    // the whole map when only nearby tiles are of interest. Distances are then looked up with getDistance( targetIndex ); distances to the
+    // tiles beyond the limit are either zero (like for unreachable tiles) or above the limit.
+    void evaluateDistanceField( int start, int color, double armyStrength, uint32_t distanceLimit, uint8_t skill = Skill::Level::EXPERT );
+
     // Override builds path to the nearest valid object
     std::list<Route::Step> buildPath( int targetIndex, bool isPlanningMode = false ) const;
 
@@ -18,6 +18,11 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <functional>
+#include <limits>
+#include <queue>
+
+#include "ground.h"
 #include "world.h"
 
 namespace
@@ -108,6 +113,70 @@ namespace
         }
     }
 
+    // Movement cost between the adjacent tiles that takes only the terrain into account (as for a hero with Expert Pathfinding)
+    uint32_t GetTerrainPenalty( const Maps::Tiles & srcTile, const Maps::Tiles & dstTile, uint8_t direction )
+    {
+        const uint32_t penalty = srcTile.isRoad() && dstTile.isRoad() ? Maps::Ground::roadPenalty : Maps::Ground::GetPenalty( srcTile, Skill::Level::EXPERT );
+
+        // Diagonal movement costs 50% more
+        return ( direction % 2 == 0 ) ? penalty * 3 / 2 : penalty;
+    }
+
+    // Evaluates terrain-only movement costs from (or to, if reversed) the start tile for all the tiles of its region. Costs of the tiles
+    // visited by the previous call are reset first, the rest of the costs vector has to be filled with the max value.
+    void EvaluateRegionCosts( int start, bool reverse, std::vector<uint32_t> & costs, std::vector<int> & visited )
+    {
+        for ( const int index : visited ) {
+            costs[index] = std::numeric_limits<uint32_t>::max();
+        }
+        visited.clear();
+
+        const std::vector<int> & offsets = GetDirectionOffsets( world.w() );
+        const uint32_t regionID = world.GetTiles( start ).GetRegion();
+
+        using QueueItem = std::pair<uint32_t, int>;
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > nodesToExplore;
+
+        costs[start] = 0;
+        visited.push_back( start );
+        nodesToExplore.emplace( 0, start );
+
+        while ( !nodesToExplore.empty() ) {
+            const QueueItem current = nodesToExplore.top();
+            nodesToExplore.pop();
+
+            if ( current.first > costs[current.second] )
+                continue;
+
+            const Maps::Tiles & tile = world.GetTiles( current.second );
+
+            for ( uint8_t direction = 0; direction < 8; ++direction ) {
+                if ( !Maps::isValidDirection( current.second, GetDirectionBitmask( direction ) ) )
+                    continue;
+
+                const int newIndex = current.second + offsets[direction];
+                const Maps::Tiles & newTile = world.GetTiles( newIndex );
+                if ( newTile.GetRegion() != regionID )
+                    continue;
+
+                // Same passability rules as for the region growth. Reversed search moves from the new tile to the current one.
+                const bool isPassable = reverse ? ( tile.GetPassable() & GetDirectionBitmask( direction ) ) != 0
+                                                : ( newTile.GetPassable() & GetDirectionBitmask( direction, true ) ) != 0;
+                if ( !isPassable )
+                    continue;
+
+                const uint32_t cost = current.first + ( reverse ? GetTerrainPenalty( newTile, tile, direction ) : GetTerrainPenalty( tile, newTile, direction ) );
+                if ( cost < costs[newIndex] ) {
+                    if ( costs[newIndex] == std::numeric_limits<uint32_t>::max() )
+                        visited.push_back( newIndex );
+
+                    costs[newIndex] = cost;
+                    nodesToExplore.emplace( cost, newIndex );
+                }
+            }
+        }
+    }
+
     void FindMissingRegions( std::vector<MapRegionNode> & rawData, const fheroes2::Size & mapSize, std::vector<MapRegion> & regions )
     {
         const uint32_t extendedWidth = mapSize.width + 2;
@@ -144,6 +213,75 @@ size_t MapRegion::getNeighboursCount() const
     return _neighbours.size();
 }
 
+uint32_t World::getDistanceEstimate( const int32_t from, const int32_t to ) const
+{
+    if ( !Maps::isValidAbsIndex( from ) || !Maps::isValidAbsIndex( to ) || from == to )
+        return 0;
+
+    const uint32_t fromRegionID = vec_tiles[from].GetRegion();
+    const uint32_t toRegionID = vec_tiles[to].GetRegion();
+    if ( fromRegionID < REGION_NODE_FOUND || toRegionID < REGION_NODE_FOUND || fromRegionID >= _regions.size() || toRegionID >= _regions.size() )
+        return 0;
+
+    const uint32_t noPath = std::numeric_limits<uint32_t>::max();
+
+    // The tile costs are reset through the list of visited tiles, so the buffer is filled only once per map
+    std::vector<uint32_t> & costs = _distanceEstimateCosts;
+    std::vector<int> & visited = _distanceEstimateVisited;
+    if ( costs.size() != vec_tiles.size() ) {
+        costs.assign( vec_tiles.size(), noPath );
+        visited.clear();
+    }
+
+    // Step 1. Detailed search within the start region: direct path and costs to reach the region portals
+    EvaluateRegionCosts( from, false, costs, visited );
+
+    uint32_t bestCost = ( fromRegionID == toRegionID ) ? costs[to] : noPath;
+
+    using QueueItem = std::pair<uint32_t, uint32_t>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > portalsToExplore;
+    std::vector<uint32_t> & portalCosts = _distanceEstimatePortalCosts;
+    portalCosts.assign( _regionPortals.size(), noPath );
+
+    for ( const uint32_t portalID : _regions[fromRegionID]._portals ) {
+        const uint32_t cost = costs[_regionPortals[portalID]._index];
+        if ( cost != noPath ) {
+            portalCosts[portalID] = cost;
+            portalsToExplore.emplace( cost, portalID );
+        }
+    }
+
+    // Step 2. Detailed reversed search within the target region: costs to reach the target from the region portals
+    EvaluateRegionCosts( to, true, costs, visited );
+
+    // Step 3. Search on the region graph
+    while ( !portalsToExplore.empty() ) {
+        const QueueItem current = portalsToExplore.top();
+        portalsToExplore.pop();
+
+        if ( current.first >= bestCost )
+            break;
+
+        if ( current.first > portalCosts[current.second] )
+            continue;
+
+        const RegionPortal & portal = _regionPortals[current.second];
+        if ( vec_tiles[portal._index].GetRegion() == toRegionID && costs[portal._index] != noPath ) {
+            bestCost = std::min( bestCost, current.first + costs[portal._index] );
+        }
+
+        for ( const std::pair<uint32_t, uint32_t> & link : portal._links ) {
+            const uint32_t cost = current.first + link.second;
+            if ( cost < portalCosts[link.first] ) {
+                portalCosts[link.first] = cost;
+                portalsToExplore.emplace( cost, link.first );
+            }
+        }
+    }
+
+    return bestCost == noPath ? 0 : bestCost;
+}
+
 size_t World::getRegionCount() const
 {
     return _regions.size();
@@ -353,4 +491,83 @@ void World::ComputeStaticAnalysis()
             }
         }
     }
+
+    // Step 10. Place portals along the region borders (and on teleports) and link them into the region graph
+    const uint32_t portalSpacing = 4;
+
+    _regionPortals.clear();
+    std::map<int, uint32_t> portalIDs;
+    std::map<std::pair<uint32_t, uint32_t>, std::vector<int> > borderPortals;
+
+    auto getPortalID = [this, &portalIDs]( const int index ) {
+        const auto it = portalIDs.find( index );
+        if ( it != portalIDs.end() )
+            return it->second;
+
+        const uint32_t portalID = static_cast<uint32_t>( _regionPortals.size() ); // Safe to do as we can't have so many portals
+        _regionPortals.emplace_back( index );
+        _regions[vec_tiles[index].GetRegion()]._portals.push_back( portalID );
+        portalIDs.emplace( index, portalID );
+        return portalID;
+    };
+
+    for ( const MapRegion & reg : _regions ) {
+        if ( reg._id < REGION_NODE_FOUND )
+            continue;
+
+        for ( const MapRegionNode & node : reg._nodes ) {
+            const Maps::Tiles & tile = vec_tiles[node.index];
+
+            // Unlike the region growth, allow to cross the coast line: heroes can do that using boats
+            for ( uint8_t direction = 0; direction < 8; ++direction ) {
+                if ( !Maps::isValidDirection( node.index, GetDirectionBitmask( direction ) ) )
+                    continue;
+
+                const int newIndex = node.index + directionOffsets[direction];
+                const Maps::Tiles & newTile = vec_tiles[newIndex];
+                const uint32_t newRegionID = newTile.GetRegion();
+
+                if ( newRegionID < REGION_NODE_FOUND || newRegionID == reg._id || ( newTile.GetPassable() & GetDirectionBitmask( direction, true ) ) == 0 )
+                    continue;
+
+                if ( AppendIfFarEnough( borderPortals[std::make_pair( reg._id, newRegionID )], node.index, portalSpacing ) ) {
+                    const uint32_t portalID = getPortalID( node.index );
+                    const uint32_t exitPortalID = getPortalID( newIndex );
+                    _regionPortals[portalID]._links.emplace_back( exitPortalID, GetTerrainPenalty( tile, newTile, direction ) );
+                }
+            }
+
+            MapsIndexes exits;
+
+            if ( node.mapObject == MP2::OBJ_STONELITHS ) {
+                exits = GetTeleportEndPoints( node.index );
+            }
+            else if ( node.mapObject == MP2::OBJ_WHIRLPOOL ) {
+                exits = GetWhirlpoolEndPoints( node.index );
+            }
+
+            for ( const int exitIndex : exits ) {
+                const uint32_t portalID = getPortalID( node.index );
+                const uint32_t exitPortalID = getPortalID( exitIndex );
+                _regionPortals[portalID]._links.emplace_back( exitPortalID, 0 );
+            }
+        }
+    }
+
+    // Link portals of the same region with the terrain-only movement costs between them
+    std::vector<uint32_t> costs( vec_tiles.size(), std::numeric_limits<uint32_t>::max() );
+    std::vector<int> visited;
+
+    for ( const MapRegion & reg : _regions ) {
+        for ( const uint32_t portalID : reg._portals ) {
+            EvaluateRegionCosts( _regionPortals[portalID]._index, false, costs, visited );
+
+            for ( const uint32_t otherPortalID : reg._portals ) {
+                const uint32_t cost = costs[_regionPortals[otherPortalID]._index];
+                if ( otherPortalID != portalID && cost != std::numeric_limits<uint32_t>::max() ) {
+                    _regionPortals[portalID]._links.emplace_back( otherPortalID, cost );
+                }
+            }
+        }
+    }
 }
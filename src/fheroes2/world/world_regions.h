@@ -22,6 +22,7 @@
 
 #include <cstdint>
 #include <set>
+#include <utility>
 #include <vector>
 
 enum
@@ -47,6 +48,19 @@ struct MapRegionNode
     {}
 };
 
+// Tile on the region border used as a node of the region graph for the hierarchical distance estimation
+struct RegionPortal
+{
+    int _index = -1;
+    // Pairs of the portal ID and the terrain-only movement cost to reach it from this portal
+    std::vector<std::pair<uint32_t, uint32_t> > _links;
+
+    RegionPortal() = default;
+    explicit RegionPortal( int index )
+        : _index( index )
+    {}
+};
+
 struct MapRegion
 {
 public:
@@ -54,6 +68,7 @@ public:
     bool _isWater = false;
     std::set<uint32_t> _neighbours;
     std::vector<MapRegionNode> _nodes;
+    std::vector<uint32_t> _portals;
     size_t _lastProcessedNode = 0;
 
     MapRegion() = default;